@@ -0,0 +1,1432 @@
+#include "Benchmarks.h"
+#include "Bitboard.h"
+#include "Broadphase.h"
+#include "ChunkedTileMap.h"
+#include "Connectivity.h"
+#include "Entities.h"
+#include "FlowField.h"
+#include "Grid.h"
+#include "HierarchicalPathfinder.h"
+#include "JobSystem.h"
+#include "LineOfSight.h"
+#include "MapFile.h"
+#include "Kernels.h"
+#include "Pathfinder.h"
+#include "Render.h"
+#include "Simulation.h"
+#include "SpatialHash.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+// Set by any check that fails, so main --bench exits non-zero on a mismatch.
+static bool failed = false;
+
+// Records a check's result and returns the word printed for it.
+static const char* Verdict(bool match)
+{
+    if (!match)
+        failed = true;
+    return match ? "match" : "MISMATCH";
+}
+
+// Runs fn repeatedly for roughly the given budget and returns the mean nanoseconds per call.
+template<typename Fn>
+static double TimeNs(Fn&& fn, double budgetSeconds = 0.25)
+{
+    long long iterations = 0;
+    auto begin = Clock::now();
+    double elapsed = 0.0;
+    do
+    {
+        fn();
+        iterations++;
+        elapsed = std::chrono::duration<double>(Clock::now() - begin).count();
+    } while (elapsed < budgetSeconds);
+    return elapsed * 1e9 / iterations;
+}
+
+static std::vector<Vector2> RandomPositions(size_t count, float worldSize = SCREEN_SIZE)
+{
+    std::vector<Vector2> positions(count);
+    for (Vector2& position : positions)
+        position = { Random(0.0f, worldSize), Random(0.0f, worldSize) };
+    return positions;
+}
+
+// -- TARGETING ---------------------------------
+// Brute-force turret x enemy scan (the original TURRET TARGETING loop) against the spatial hash.
+// On the 800px screen a 250px range covers about a third of the map, so a larger world is measured too.
+static void BenchTargeting(float worldSize)
+{
+    const float range = 250.0f;
+    const size_t turretCount = 200;
+    const size_t enemyCounts[] = { 100, 1000, 10000 };
+
+    srand(1);
+    std::vector<Vector2> turrets = RandomPositions(turretCount, worldSize);
+    std::vector<int> bruteTargets(turretCount);
+    std::vector<int> hashTargets(turretCount);
+    SpatialHash grid(range * 0.5f);
+
+    printf("targeting: %zu turrets, range %.0f, world %.0f\n", turretCount, range, worldSize);
+    for (size_t enemyCount : enemyCounts)
+    {
+        std::vector<Vector2> enemies = RandomPositions(enemyCount, worldSize);
+
+        double bruteNs = TimeNs([&]() {
+            for (size_t t = 0; t < turrets.size(); t++)
+            {
+                int target = -1;
+                for (size_t e = 0; e < enemies.size(); e++)
+                {
+                    if (Distance(turrets[t], enemies[e]) < range)
+                        target = (int)e;
+                }
+                bruteTargets[t] = target;
+            }
+        });
+
+        double hashNs = TimeNs([&]() {
+            grid.Begin(enemies.size());
+            for (size_t e = 0; e < enemies.size(); e++)
+                grid.Insert((int)e, enemies[e]);
+            grid.End();
+            for (size_t t = 0; t < turrets.size(); t++)
+            {
+                int target = -1;
+                grid.Query(turrets[t], range, [&target](int id, Vector2) {
+                    target = std::max(target, id);
+                });
+                hashTargets[t] = target;
+            }
+        });
+
+        bool match = bruteTargets == hashTargets;
+        printf("  enemies %6zu  brute %12.0f ns  hash %12.0f ns  speedup %6.2fx  %s\n",
+            enemyCount, bruteNs, hashNs, bruteNs / hashNs, Verdict(match));
+    }
+}
+
+// -- BROADPHASE ---------------------------------
+// The old bullet x enemy double loop against sweep-and-prune plus the same circle test, on the
+// stress layout: enemies crowded into a few vertical path columns, bullets spread over the world.
+static void BenchBroadphase()
+{
+    const float bulletRadius = 15.0f;
+    const float enemyRadius = 20.0f;
+    const float reach = bulletRadius + enemyRadius;
+    const size_t counts[][2] = { { 0, 10000 }, { 10000, 1000 }, { 100000, 1000 } };
+    const float columns[] = { 120.0f, 360.0f, 600.0f };
+
+    printf("broadphase: enemies in %zu path columns, bullets over the %.0fpx world\n",
+        sizeof(columns) / sizeof(columns[0]), SCREEN_SIZE);
+    for (const auto& count : counts)
+    {
+        srand(4);
+        std::vector<Vector2> bullets = RandomPositions(count[0]);
+        std::vector<Vector2> enemies(count[1]);
+        for (size_t e = 0; e < enemies.size(); e++)
+            enemies[e] = { columns[e % 3] + Random(-20.0f, 20.0f), Random(0.0f, SCREEN_SIZE) };
+        auto hit = [&](int b, int e) { return DistanceSqr(bullets[b], enemies[e]) < reach * reach; };
+
+        std::vector<BroadphasePair> bruteHits;
+        double bruteNs = TimeNs([&]() {
+            bruteHits.clear();
+            for (int b = 0; b < (int)bullets.size(); b++)
+            {
+                for (int e = 0; e < (int)enemies.size(); e++)
+                {
+                    if (hit(b, e))
+                        bruteHits.push_back({ b, e });
+                }
+            }
+        });
+
+        // The first Update sorts from scratch; the timed ones repair an order that is already right,
+        // as they do from tick to tick.
+        SweepAndPrune sweep;
+        sweep.Grow(0, (int)bullets.size());
+        sweep.Grow(1, (int)enemies.size());
+        auto bounds = [&](int layer, int index, float& minX, float& maxX, float& minY, float& maxY) {
+            Vector2 position = layer == 0 ? bullets[index] : enemies[index];
+            float radius = layer == 0 ? bulletRadius : enemyRadius;
+            minX = position.x - radius;
+            maxX = position.x + radius;
+            minY = position.y - radius;
+            maxY = position.y + radius;
+        };
+        sweep.Update(bounds);
+        std::vector<BroadphasePair> pairs;
+        std::vector<BroadphasePair> sweepHits;
+        double sweepNs = TimeNs([&]() {
+            sweep.Update(bounds);
+            sweep.FindPairs(pairs);
+            sweepHits.clear();
+            for (const BroadphasePair& pair : pairs)
+            {
+                if (hit(pair.a, pair.b))
+                    sweepHits.push_back(pair);
+            }
+        });
+
+        bool match = bruteHits.size() == sweepHits.size() &&
+            std::equal(bruteHits.begin(), bruteHits.end(), sweepHits.begin(), [](const BroadphasePair& lhs, const BroadphasePair& rhs) {
+                return lhs.a == rhs.a && lhs.b == rhs.b;
+            });
+        printf("  bullets %6zu enemies %5zu  brute %12.0f ns  sweep %12.0f ns  speedup %7.2fx  candidates %8zu  hits %7zu  %s\n",
+            count[0], count[1], bruteNs, sweepNs, bruteNs / sweepNs, pairs.size(), sweepHits.size(), Verdict(match));
+    }
+}
+
+// -- MOVEMENT ---------------------------------
+// The old array-of-structs bullet update against the structure-of-arrays kernel, one tick each.
+static void BenchMovement()
+{
+    const size_t bulletCount = 1000000;
+    const float speed = 500.0f;
+    const float dt = 1.0f / 60.0f;
+
+    srand(2);
+    std::vector<Bullet> aos(bulletCount);
+    BulletStore soa;
+    for (Bullet& bullet : aos)
+    {
+        bullet.position = { Random(0.0f, SCREEN_SIZE), Random(0.0f, SCREEN_SIZE) };
+        bullet.direction = Normalize(Vector2{ Random(-1.0f, 1.0f), Random(-1.0f, 1.0f) });
+        soa.Insert(bullet);
+    }
+
+    double aosNs = TimeNs([&]() {
+        for (Bullet& bullet : aos)
+        {
+            bullet.position = bullet.position + bullet.direction * speed * dt;
+            bullet.time += dt;
+        }
+    });
+
+    double soaNs = TimeNs([&]() {
+        MoveKernel(soa.x.data(), soa.y.data(), soa.dirX.data(), soa.dirY.data(), speed * dt, soa.size());
+        AddKernel(soa.time.data(), dt, soa.size());
+    });
+
+    printf("movement: %zu bullets per tick\n", bulletCount);
+    printf("  aos %12.0f ns  soa kernel %12.0f ns  speedup %6.2fx\n", aosNs, soaNs, aosNs / soaNs);
+}
+
+// -- BATCH KERNELS ---------------------------------
+// Each span kernel against a loop calling its Math.h counterpart per element, plus how far apart
+// their results are. Kernels that work in place are fed values they leave bounded (scaling by -1,
+// lerping towards fixed targets) so repeated timing runs don't drift into denormals.
+struct KernelColumns
+{
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> toX;
+    std::vector<float> toY;
+    std::vector<float> out;
+};
+
+// Distance in units in the last place, counting across zero; 0 means bit-identical.
+static long long UlpDistance(float a, float b)
+{
+    int32_t ia;
+    int32_t ib;
+    memcpy(&ia, &a, sizeof(ia));
+    memcpy(&ib, &b, sizeof(ib));
+    long long oa = ia < 0 ? (long long)INT32_MIN - ia : ia;
+    long long ob = ib < 0 ? (long long)INT32_MIN - ib : ib;
+    return oa > ob ? oa - ob : ob - oa;
+}
+
+static long long MaxUlpDistance(const std::vector<float>& a, const std::vector<float>& b)
+{
+    long long worst = 0;
+    for (size_t i = 0; i < a.size(); i++)
+        worst = std::max(worst, UlpDistance(a[i], b[i]));
+    return worst;
+}
+
+template<typename Scalar, typename Kernel>
+static void CompareKernel(const char* name, const KernelColumns& input, Scalar&& scalar, Kernel&& kernel)
+{
+    KernelColumns a = input;
+    KernelColumns b = input;
+    scalar(a);
+    kernel(b);
+    // Bit-identical unless the compiler fused the scalar loop's multiply-adds; that shifts a few ulp.
+    const long long tolerance = 4;
+    long long error = std::max({ MaxUlpDistance(a.x, b.x), MaxUlpDistance(a.y, b.y), MaxUlpDistance(a.out, b.out) });
+
+    double scalarNs = TimeNs([&]() { scalar(a); });
+    double kernelNs = TimeNs([&]() { kernel(b); });
+    printf("  %-12s scalar %10.0f ns  kernel %10.0f ns  speedup %6.2fx  max error %lld ulp  %s\n",
+        name, scalarNs, kernelNs, scalarNs / kernelNs, error, Verdict(error <= tolerance));
+}
+
+static void BenchKernels()
+{
+    const size_t count = 65536;
+    const Vector2 point = { 400.0f, 300.0f };
+
+    srand(13);
+    KernelColumns input;
+    input.x.resize(count);
+    input.y.resize(count);
+    input.toX.resize(count);
+    input.toY.resize(count);
+    input.out.resize(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        input.x[i] = Random(-SCREEN_SIZE, SCREEN_SIZE);
+        input.y[i] = Random(-SCREEN_SIZE, SCREEN_SIZE);
+        input.toX[i] = Random(-SCREEN_SIZE, SCREEN_SIZE);
+        input.toY[i] = Random(-SCREEN_SIZE, SCREEN_SIZE);
+    }
+    input.x[0] = input.y[0] = 0.0f;     // Normalize's zero-length branch.
+
+    printf("batch kernels: %zu elements\n", count);
+    CompareKernel("scale", input, [](KernelColumns& c) {
+        for (size_t i = 0; i < c.x.size(); i++)
+            c.x[i] = Scale(Vector2{ c.x[i], 0.0f }, -1.0f).x;
+    }, [](KernelColumns& c) {
+        ScaleKernel(c.x.data(), -1.0f, c.x.size());
+    });
+    CompareKernel("normalize", input, [](KernelColumns& c) {
+        for (size_t i = 0; i < c.x.size(); i++)
+        {
+            Vector2 v = Normalize(Vector2{ c.x[i], c.y[i] });
+            c.x[i] = v.x;
+            c.y[i] = v.y;
+        }
+    }, [](KernelColumns& c) {
+        NormalizeKernel(c.x.data(), c.y.data(), c.x.size());
+    });
+    CompareKernel("distanceSqr", input, [point](KernelColumns& c) {
+        for (size_t i = 0; i < c.x.size(); i++)
+            c.out[i] = DistanceSqr(point, Vector2{ c.x[i], c.y[i] });
+    }, [point](KernelColumns& c) {
+        DistanceSqrKernel(point, c.x.data(), c.y.data(), c.out.data(), c.x.size());
+    });
+    CompareKernel("distance", input, [point](KernelColumns& c) {
+        for (size_t i = 0; i < c.x.size(); i++)
+            c.out[i] = Distance(point, Vector2{ c.x[i], c.y[i] });
+    }, [point](KernelColumns& c) {
+        DistanceKernel(point, c.x.data(), c.y.data(), c.out.data(), c.x.size());
+    });
+    CompareKernel("lerp", input, [](KernelColumns& c) {
+        for (size_t i = 0; i < c.x.size(); i++)
+        {
+            Vector2 v = Lerp(Vector2{ c.x[i], c.y[i] }, Vector2{ c.toX[i], c.toY[i] }, 0.25f);
+            c.x[i] = v.x;
+            c.y[i] = v.y;
+        }
+    }, [](KernelColumns& c) {
+        LerpKernel(c.x.data(), c.y.data(), c.toX.data(), c.toY.data(), 0.25f, c.x.size());
+    });
+}
+
+// -- TRIG KERNELS ---------------------------------
+// The polynomial sin/cos/atan2 kernels against per-element sinf/cosf/atan2f and Rotate: time and the
+// worst absolute error, on the principal range and on angles up to 1e4 radians.
+static double MaxAbsError(const std::vector<float>& a, const std::vector<float>& b)
+{
+    double worst = 0.0;
+    for (size_t i = 0; i < a.size(); i++)
+        worst = std::max(worst, fabs((double)a[i] - b[i]));
+    return worst;
+}
+
+static void BenchTrig()
+{
+    const size_t count = 65536;
+    const float bounds[] = { PI, 10000.0f };
+
+    srand(15);
+    std::vector<float> angles(count);
+    std::vector<float> sines(count);
+    std::vector<float> cosines(count);
+    std::vector<float> refSines(count);
+    std::vector<float> refCosines(count);
+
+    printf("trig kernels: %zu elements\n", count);
+    for (float bound : bounds)
+    {
+        for (float& angle : angles)
+            angle = Random(-bound, bound);
+        double scalarNs = TimeNs([&]() {
+            for (size_t i = 0; i < count; i++)
+            {
+                refSines[i] = sinf(angles[i]);
+                refCosines[i] = cosf(angles[i]);
+            }
+        });
+        double kernelNs = TimeNs([&]() {
+            SinCosKernel(angles.data(), sines.data(), cosines.data(), count);
+        });
+        printf("  sincos |a| < %-7.0f scalar %10.0f ns  kernel %10.0f ns  speedup %6.2fx  max error %.2e\n",
+            bound, scalarNs, kernelNs, scalarNs / kernelNs, std::max(MaxAbsError(sines, refSines), MaxAbsError(cosines, refCosines)));
+    }
+
+    // Points over a wide spread of magnitudes, with the axes, the origin and signed zeros mixed in.
+    std::vector<float> x(count);
+    std::vector<float> y(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        x[i] = Random(-1.0f, 1.0f) * powf(10.0f, Random(-3.0f, 3.0f));
+        y[i] = Random(-1.0f, 1.0f) * powf(10.0f, Random(-3.0f, 3.0f));
+        if (i % 97 == 0)
+            x[i] = i % 2 ? 0.0f : -0.0f;
+        if (i % 89 == 0)
+            y[i] = i % 2 ? 0.0f : -0.0f;
+    }
+    std::vector<float> atans(count);
+    std::vector<float> refAtans(count);
+    double scalarNs = TimeNs([&]() {
+        for (size_t i = 0; i < count; i++)
+            refAtans[i] = atan2f(y[i], x[i]);
+    });
+    double kernelNs = TimeNs([&]() {
+        Atan2Kernel(y.data(), x.data(), atans.data(), count);
+    });
+    printf("  atan2               scalar %10.0f ns  kernel %10.0f ns  speedup %6.2fx  max error %.2e\n",
+        scalarNs, kernelNs, scalarNs / kernelNs, MaxAbsError(atans, refAtans));
+
+    for (float& angle : angles)
+        angle = Random(-PI, PI);
+    std::vector<float> rotatedX = x;
+    std::vector<float> rotatedY = y;
+    std::vector<float> refX(count);
+    std::vector<float> refY(count);
+    scalarNs = TimeNs([&]() {
+        for (size_t i = 0; i < count; i++)
+        {
+            Vector2 v = Rotate(Vector2{ x[i], y[i] }, angles[i]);
+            refX[i] = v.x;
+            refY[i] = v.y;
+        }
+    });
+    kernelNs = TimeNs([&]() {
+        rotatedX = x;
+        rotatedY = y;
+        RotateKernel(rotatedX.data(), rotatedY.data(), angles.data(), count);
+    });
+    // Relative to each vector's length, since the inputs span six orders of magnitude.
+    double rotateError = 0.0;
+    for (size_t i = 0; i < count; i++)
+    {
+        double length = std::max(1e-30, (double)Length(Vector2{ x[i], y[i] }));
+        rotateError = std::max(rotateError, Length(Vector2{ rotatedX[i] - refX[i], rotatedY[i] - refY[i] }) / length);
+    }
+    printf("  rotate              scalar %10.0f ns  kernel %10.0f ns  speedup %6.2fx  max error %.2e (of length, copy included)\n",
+        scalarNs, kernelNs, scalarNs / kernelNs, rotateError);
+}
+
+// -- PRECISION ---------------------------------
+// ExactMath against FastMath for the calls that aim bullets and check ranges. Errors are relative to
+// a double-precision reference, over lengths spread log-uniformly from 1e-3 to 1e5.
+template<typename Precision>
+static double TimePrecision(const std::vector<Vector2>& vectors, Vector2 origin, std::vector<float>& out)
+{
+    return TimeNs([&]() {
+        for (size_t i = 0; i < vectors.size(); i++)
+        {
+            Vector2 direction = Normalize<Precision>(vectors[i]);
+            out[4 * i] = direction.x;
+            out[4 * i + 1] = direction.y;
+            out[4 * i + 2] = Length<Precision>(vectors[i]);
+            out[4 * i + 3] = Distance<Precision>(origin, vectors[i]);
+        }
+    }) / vectors.size();
+}
+
+static void BenchPrecision()
+{
+    const size_t count = 1000000;
+    const Vector2 origin = { 0.0f, 0.0f };
+
+    srand(14);
+    std::vector<Vector2> vectors(count);
+    for (Vector2& v : vectors)
+    {
+        float length = powf(10.0f, Random(-3.0f, 5.0f));
+        float angle = Random(-PI, PI);
+        v = { length * cosf(angle), length * sinf(angle) };
+    }
+
+    double inverseError = 0.0;
+    double lengthError = 0.0;
+    double unitError = 0.0;
+    for (Vector2 v : vectors)
+    {
+        double lengthSqr = (double)v.x * v.x + (double)v.y * v.y;
+        double exact = sqrt(lengthSqr);
+        inverseError = std::max(inverseError, fabs(FastMath::InverseSqrt((float)lengthSqr) * exact - 1.0));
+        lengthError = std::max(lengthError, fabs(Length<FastMath>(v) / exact - 1.0));
+        lengthError = std::max(lengthError, fabs(Distance<FastMath>(origin, v) / exact - 1.0));
+        Vector2 unit = Normalize<FastMath>(v);
+        unitError = std::max(unitError, fabs(sqrt((double)unit.x * unit.x + (double)unit.y * unit.y) - 1.0));
+    }
+
+    bool exactMatch = true;
+    for (Vector2 v : vectors)
+    {
+        Vector2 a = Normalize(v);
+        Vector2 b = Normalize<ExactMath>(v);
+        exactMatch = exactMatch && a.x == b.x && a.y == b.y && Length(v) == Length<ExactMath>(v) &&
+            Distance(origin, v) == Distance<ExactMath>(origin, v);
+    }
+
+    std::vector<float> out(4 * count);
+    double exactNs = TimePrecision<ExactMath>(vectors, origin, out);
+    double fastNs = TimePrecision<FastMath>(vectors, origin, out);
+
+    printf("precision: %zu vectors, Normalize + Length + Distance per vector\n", count);
+    printf("  exact %6.2f ns  fast %6.2f ns  speedup %5.2fx  exact policy %s\n",
+        exactNs, fastNs, exactNs / fastNs, Verdict(exactMatch));
+    printf("  fast max relative error: inverse sqrt %.2e  length/distance %.2e  normalized length %.2e\n",
+        inverseError, lengthError, unitError);
+}
+
+// -- MATRIX ---------------------------------
+// The SIMD matrix functions against the scalar reference, per call, over a mix of 2D instance
+// transforms (scale, rotate, translate) and general diagonally dominant matrices. Multiply and
+// Transpose should match exactly; Invert is judged by how far M * inverse lands from identity.
+static float MaxAbs(Matrix mat)
+{
+    const float* m = (const float*)&mat;
+    float worst = 0.0f;
+    for (int i = 0; i < 16; i++)
+        worst = std::max(worst, fabsf(m[i]));
+    return worst;
+}
+
+// Largest element difference as a fraction of the reference's largest element, so cancellation in
+// one element can't inflate it.
+static double RelativeError(Matrix reference, Matrix other)
+{
+    return (double)MaxAbs(Subtract(reference, other)) / std::max(MaxAbs(reference), FLT_MIN);
+}
+
+static double IdentityError(Matrix product)
+{
+    return MaxAbs(Subtract(product, MatrixIdentity()));
+}
+
+static void BenchMatrix()
+{
+    const size_t count = 4096;
+    const size_t pointCount = 65536;
+
+    srand(16);
+    std::vector<Matrix> matrices(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        Matrix& mat = matrices[i];
+        if (i % 2 == 0)
+        {
+            float scale = Random(0.25f, 4.0f);
+            mat = Multiply(Multiply(Scale(scale, scale, 1.0f), RotateZ(Random(-PI, PI))),
+                Translate(Random(0.0f, SCREEN_SIZE), Random(0.0f, SCREEN_SIZE), 0.0f));
+        }
+        else
+        {
+            float* m = (float*)&mat;
+            for (int j = 0; j < 16; j++)
+                m[j] = Random(-1.0f, 1.0f) + (j % 5 == 0 ? 4.0f : 0.0f);
+        }
+    }
+
+    double multiplyError = 0.0;
+    bool transposeMatch = true;
+    double invertDifference = 0.0;
+    double referenceResidual = 0.0;
+    double simdResidual = 0.0;
+    for (size_t i = 0; i < count; i++)
+    {
+        const Matrix& a = matrices[i];
+        const Matrix& b = matrices[count - 1 - i];
+        multiplyError = std::max(multiplyError, RelativeError(Multiply(a, b), MultiplySimd(a, b)));
+        Matrix transposed = Transpose(a);
+        Matrix transposedSimd = TransposeSimd(a);
+        transposeMatch = transposeMatch && memcmp(&transposed, &transposedSimd, sizeof(Matrix)) == 0;
+        Matrix reference = Invert(a);
+        Matrix inverse = InvertSimd(a);
+        invertDifference = std::max(invertDifference, RelativeError(reference, inverse));
+        referenceResidual = std::max(referenceResidual, IdentityError(Multiply(a, reference)));
+        simdResidual = std::max(simdResidual, IdentityError(Multiply(a, inverse)));
+    }
+
+    std::vector<Matrix> out(count);
+    auto time = [&](auto&& op) {
+        return TimeNs([&]() {
+            for (size_t i = 0; i < count; i++)
+                out[i] = op(matrices[i], matrices[count - 1 - i]);
+        }) / count;
+    };
+    double multiplyNs = time([](const Matrix& a, const Matrix& b) { return Multiply(a, b); });
+    double multiplySimdNs = time([](const Matrix& a, const Matrix& b) { return MultiplySimd(a, b); });
+    double transposeNs = time([](const Matrix& a, const Matrix&) { return Transpose(a); });
+    double transposeSimdNs = time([](const Matrix& a, const Matrix&) { return TransposeSimd(a); });
+    double invertNs = time([](const Matrix& a, const Matrix&) { return Invert(a); });
+    double invertSimdNs = time([](const Matrix& a, const Matrix&) { return InvertSimd(a); });
+
+    // Bit-identical unless the compiler fused the scalar side's multiply-adds, which moves results by
+    // rounding error relative to the largest term.
+    const double tolerance = 4.0 * FLT_EPSILON;
+    printf("matrix: %zu matrices, ns per call\n", count);
+    printf("  multiply   scalar %6.2f ns  simd %6.2f ns  speedup %5.2fx  max error %.2e  %s\n",
+        multiplyNs, multiplySimdNs, multiplyNs / multiplySimdNs, multiplyError, Verdict(multiplyError <= tolerance));
+    printf("  transpose  scalar %6.2f ns  simd %6.2f ns  speedup %5.2fx  %s\n",
+        transposeNs, transposeSimdNs, transposeNs / transposeSimdNs, Verdict(transposeMatch));
+    // The block method rounds differently, so it passes if it leaves M * inverse as close to identity.
+    printf("  invert     scalar %6.2f ns  simd %6.2f ns  speedup %5.2fx  difference %.2e  residual %.2e vs %.2e  %s\n",
+        invertNs, invertSimdNs, invertNs / invertSimdNs, invertDifference, simdResidual, referenceResidual,
+        Verdict(simdResidual <= 2.0 * referenceResidual));
+
+    std::vector<float> x(pointCount);
+    std::vector<float> y(pointCount);
+    for (size_t i = 0; i < pointCount; i++)
+    {
+        x[i] = Random(-SCREEN_SIZE, SCREEN_SIZE);
+        y[i] = Random(-SCREEN_SIZE, SCREEN_SIZE);
+    }
+    const Matrix& mat = matrices[0];
+    std::vector<float> refX = x;
+    std::vector<float> refY = y;
+    double scalarNs = TimeNs([&]() {
+        refX = x;
+        refY = y;
+        for (size_t i = 0; i < pointCount; i++)
+        {
+            Vector2 v = Multiply(Vector2{ refX[i], refY[i] }, mat);
+            refX[i] = v.x;
+            refY[i] = v.y;
+        }
+    });
+    std::vector<float> kernelX = x;
+    std::vector<float> kernelY = y;
+    double kernelNs = TimeNs([&]() {
+        kernelX = x;
+        kernelY = y;
+        TransformKernel(kernelX.data(), kernelY.data(), mat, pointCount);
+    });
+    double transformError = 0.0;
+    for (size_t i = 0; i < pointCount; i++)
+    {
+        double scale = MaxAbs(mat) * (fabsf(x[i]) + fabsf(y[i]) + 1.0f);
+        transformError = std::max(transformError, std::max(fabs((double)refX[i] - kernelX[i]), fabs((double)refY[i] - kernelY[i])) / scale);
+    }
+    printf("  transform  %zu points  scalar %10.0f ns  kernel %10.0f ns  speedup %5.2fx  max error %.2e  %s (copy included)\n",
+        pointCount, scalarNs, kernelNs, scalarNs / kernelNs, transformError, Verdict(transformError <= tolerance));
+}
+
+// -- QUATERNION INTERPOLATION ---------------------------------
+// The batch Nlerp and Slerp kernels against Nlerp and Slerp called per quaternion, on pairs a few
+// degrees apart (all in Slerp's Nlerp range) and on pairs at random orientations.
+struct QuaternionColumns
+{
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> z;
+    std::vector<float> w;
+
+    explicit QuaternionColumns(size_t count) : x(count), y(count), z(count), w(count) {}
+    QuaternionPlanes Planes() { return { x.data(), y.data(), z.data(), w.data() }; }
+    Quaternion Get(size_t i) const { return { x[i], y[i], z[i], w[i] }; }
+    void Set(size_t i, Quaternion q) { x[i] = q.x; y[i] = q.y; z[i] = q.z; w[i] = q.w; }
+};
+
+static Quaternion RandomOrientation()
+{
+    Vector3 axis = { Random(-1.0f, 1.0f), Random(-1.0f, 1.0f), Random(-1.0f, 1.0f) };
+    return FromAxisAngle(axis, Random(-PI, PI));
+}
+
+template<typename Scalar, typename Kernel>
+static void CompareInterpolation(const char* name, QuaternionColumns& from, QuaternionColumns& to, Scalar&& scalar, Kernel&& kernel)
+{
+    const float amount = 0.3f;
+    size_t count = from.x.size();
+    QuaternionColumns reference(count);
+    QuaternionColumns out(count);
+    double scalarNs = TimeNs([&]() {
+        for (size_t i = 0; i < count; i++)
+            reference.Set(i, scalar(from.Get(i), to.Get(i), amount));
+    });
+    double kernelNs = TimeNs([&]() {
+        kernel(from.Planes(), to.Planes(), out.Planes(), amount, count);
+    });
+    double error = std::max({ MaxAbsError(out.x, reference.x), MaxAbsError(out.y, reference.y),
+        MaxAbsError(out.z, reference.z), MaxAbsError(out.w, reference.w) });
+    // The kernel's polynomial sine and the scalar Slerp's snap near cos = 1 differ by up to ~1e-4.
+    const double tolerance = 1e-3;
+    printf("  %-14s scalar %10.0f ns  kernel %10.0f ns  speedup %6.2fx  max error %.2e  %s\n",
+        name, scalarNs, kernelNs, scalarNs / kernelNs, error, Verdict(error <= tolerance));
+}
+
+static void BenchQuaternion()
+{
+    const size_t count = 65536;
+
+    srand(17);
+    QuaternionColumns from(count);
+    QuaternionColumns near(count);
+    QuaternionColumns wide(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        Quaternion q = RandomOrientation();
+        Vector3 axis = { Random(-1.0f, 1.0f), Random(-1.0f, 1.0f), Random(-1.0f, 1.0f) };
+        from.Set(i, q);
+        near.Set(i, Multiply(q, FromAxisAngle(axis, Random(-0.5f, 0.5f))));
+        wide.Set(i, RandomOrientation());
+    }
+
+    auto nlerp = [](Quaternion a, Quaternion b, float amount) { return Nlerp(a, b, amount); };
+    auto slerp = [](Quaternion a, Quaternion b, float amount) { return Slerp(a, b, amount); };
+    printf("quaternion interpolation: %zu pairs\n", count);
+    CompareInterpolation("nlerp", from, wide, nlerp, NlerpKernel);
+    CompareInterpolation("slerp near", from, near, slerp, SlerpKernel);
+    CompareInterpolation("slerp wide", from, wide, slerp, SlerpKernel);
+}
+
+// -- PATHFINDING ---------------------------------
+// Full A* against D* Lite repairs after single-cell edits, on square maps with a fifth of the cells
+// blocked at random. Each edit blocks a cell on the current route (forcing a detour) and then
+// reopens it; both halves are timed. Route lengths are checked against A* after every edit.
+static double ElapsedNs(Clock::time_point begin)
+{
+    return std::chrono::duration<double, std::nano>(Clock::now() - begin).count();
+}
+
+static void BenchPathfinding()
+{
+    const int sizes[] = { 20, 64, 256, 1024, 2048 };
+    const int editCount = 8;
+
+    printf("pathfinding: 20%% blocked, corner to corner, %d block/unblock edits on the route\n", editCount);
+    for (int size : sizes)
+    {
+        srand(3);
+        Cell start{ 0, 0 };
+        Cell goal{ size - 1, size - 1 };
+        NavGrid grid(size, size);
+        std::vector<Cell> route;
+        do
+        {
+            for (int row = 0; row < size; row++)
+            {
+                for (int col = 0; col < size; col++)
+                {
+                    bool corner = std::max(row, col) < 2 || std::min(row, col) >= size - 2;
+                    grid.SetPassable({ row, col }, corner || rand() % 5 != 0);
+                }
+            }
+        } while (!FindPathAStar(grid, start, goal, route));     // Reroll the rare map with the corners cut off.
+
+        size_t astarExpanded = 0;
+        double astarNs = TimeNs([&]() {
+            FindPathAStar(grid, start, goal, route, &astarExpanded);
+        }, 0.1);
+
+        auto begin = Clock::now();
+        DStarLite planner(grid, start, goal);
+        bool found = planner.Plan(route);
+        double initialNs = ElapsedNs(begin);
+        size_t initialExpanded = planner.Expanded();
+
+        double repairNs = 0.0;
+        double fullNs = 0.0;
+        size_t repairExpanded = 0;
+        int repairs = 0;
+        bool match = true;
+        std::vector<Cell> check;
+        for (int edit = 0; edit < editCount && found && route.size() > 2; edit++)
+        {
+            Cell cell = route[1 + rand() % (route.size() - 2)];
+            for (bool passable : { false, true })
+            {
+                begin = Clock::now();
+                planner.SetPassable(cell, passable);
+                bool repaired = planner.Plan(route);
+                repairNs += ElapsedNs(begin);
+                repairExpanded += planner.Expanded();
+
+                grid.SetPassable(cell, passable);
+                begin = Clock::now();
+                bool searched = FindPathAStar(grid, start, goal, check);
+                fullNs += ElapsedNs(begin);
+
+                match = match && repaired == searched && route.size() == check.size();
+                repairs++;
+                found = repaired || passable;
+            }
+        }
+        repairs = std::max(repairs, 1);
+
+        printf("  %4dx%-4d  route %7zu  astar %12.0f ns (%8zu expanded)  dstar initial %12.0f ns (%8zu)\n",
+            size, size, route.size(), astarNs, astarExpanded, initialNs, initialExpanded);
+        printf("             per edit: astar rerun %12.0f ns  dstar repair %12.0f ns (%8zu expanded)  speedup %7.2fx  %s\n",
+            fullNs / repairs, repairNs / repairs, repairExpanded / repairs, fullNs / repairNs, Verdict(match));
+    }
+}
+
+// -- HIERARCHICAL PATHFINDING ---------------------------------
+// HPA* with 16x16 clusters against flat A* on the same 20%-blocked maps: one-time build, query time
+// for random far-apart pairs (coarse only, and refined to tiles), route length relative to optimal,
+// and the cost of rebuilding after a single-cell edit.
+static void BenchHierarchical()
+{
+    const int sizes[] = { 256, 1024, 2048 };
+    const int queryCount = 8;
+    const int editCount = 16;
+
+    printf("hpa*: 16x16 clusters, 20%% blocked, %d random queries, %d edits\n", queryCount, editCount);
+    for (int size : sizes)
+    {
+        srand(5);
+        NavGrid grid(size, size);
+        for (int row = 0; row < size; row++)
+        {
+            for (int col = 0; col < size; col++)
+                grid.SetPassable({ row, col }, rand() % 5 != 0);
+        }
+
+        auto begin = Clock::now();
+        HierarchicalPathfinder hpa(grid, 16);
+        double buildNs = ElapsedNs(begin);
+
+        // Endpoints in opposite quarters of the map so every query crosses many clusters.
+        std::vector<Cell> starts;
+        std::vector<Cell> goals;
+        std::vector<Cell> route;
+        while ((int)starts.size() < queryCount)
+        {
+            Cell start{ rand() % (size / 4), rand() % (size / 4) };
+            Cell goal{ size - 1 - rand() % (size / 4), size - 1 - rand() % (size / 4) };
+            if (FindPathAStar(grid, start, goal, route))
+            {
+                starts.push_back(start);
+                goals.push_back(goal);
+            }
+        }
+
+        double flatNs = 0.0;
+        double abstractNs = 0.0;
+        double refinedNs = 0.0;
+        double lengthRatio = 0.0;
+        std::vector<Cell> abstract;
+        std::vector<Cell> refined;
+        for (int q = 0; q < queryCount; q++)
+        {
+            begin = Clock::now();
+            FindPathAStar(grid, starts[q], goals[q], route);
+            flatNs += ElapsedNs(begin);
+
+            begin = Clock::now();
+            hpa.FindAbstractPath(starts[q], goals[q], abstract);
+            abstractNs += ElapsedNs(begin);
+
+            begin = Clock::now();
+            hpa.FindPath(starts[q], goals[q], refined);
+            refinedNs += ElapsedNs(begin);
+            lengthRatio += (double)refined.size() / route.size();
+        }
+
+        double editNs = 0.0;
+        size_t rebuilt = 0;
+        for (int edit = 0; edit < editCount; edit++)
+        {
+            Cell cell{ rand() % size, rand() % size };
+            begin = Clock::now();
+            hpa.SetPassable(cell, !hpa.Grid().Passable(cell));
+            rebuilt += hpa.Rebuild();
+            editNs += ElapsedNs(begin);
+        }
+
+        printf("  %4dx%-4d  build %12.0f ns  nodes %7zu  rebuild per edit %9.0f ns (%.1f clusters)\n",
+            size, size, buildNs, hpa.NodeCount(), editNs / editCount, (double)rebuilt / editCount);
+        printf("             per query: flat astar %12.0f ns  hpa coarse %10.0f ns  hpa refined %10.0f ns  speedup %6.2fx  length %.3fx optimal\n",
+            flatNs / queryCount, abstractNs / queryCount, refinedNs / queryCount, flatNs / refinedNs, lengthRatio / queryCount);
+    }
+}
+
+// -- PLACEMENT ---------------------------------
+// "Would a turret here cut the route?" answered from the articulation-point table against the
+// naive check (block the cell, search again). Edits toggle random cells; most miss the chain of
+// blocks between spawn and goal and need no recompute. Answers are checked against the naive one.
+static void BenchPlacement()
+{
+    const int sizes[] = { 64, 256, 1024, 2048 };
+    const size_t queryCount = 1000000;
+    const int naiveCount = 16;
+    const int editCount = 256;
+
+    printf("placement: 20%% blocked, corner to corner, %d edits\n", editCount);
+    for (int size : sizes)
+    {
+        srand(6);
+        Cell source{ 0, 0 };
+        Cell target{ size - 1, size - 1 };
+        NavGrid grid(size, size);
+        std::vector<Cell> route;
+        do
+        {
+            for (int row = 0; row < size; row++)
+            {
+                for (int col = 0; col < size; col++)
+                {
+                    bool corner = std::max(row, col) < 2 || std::min(row, col) >= size - 2;
+                    grid.SetPassable({ row, col }, corner || rand() % 5 != 0);
+                }
+            }
+        } while (!FindPathAStar(grid, source, target, route));
+
+        auto begin = Clock::now();
+        Connectivity connectivity(grid, source, target);
+        double buildNs = ElapsedNs(begin);
+
+        std::vector<Cell> cells(queryCount);
+        std::vector<uint8_t> answers(queryCount);
+        for (Cell& cell : cells)
+            cell = { rand() % size, rand() % size };
+        double queryNs = TimeNs([&]() {
+            for (size_t i = 0; i < queryCount; i++)
+                answers[i] = connectivity.WouldDisconnect(cells[i]);
+        });
+
+        // The naive check, on cells along the route so each one is a real candidate.
+        bool match = true;
+        double naiveNs = 0.0;
+        for (int i = 0; i < naiveCount; i++)
+        {
+            Cell cell = route[rand() % route.size()];
+            begin = Clock::now();
+            NavGrid blocked = grid;
+            blocked.SetPassable(cell, false);
+            std::vector<Cell> detour;
+            bool cut = !FindPathAStar(blocked, source, target, detour);
+            naiveNs += ElapsedNs(begin);
+            match = match && cut == connectivity.WouldDisconnect(cell);
+        }
+
+        size_t recomputesBefore = connectivity.Recomputes();
+        begin = Clock::now();
+        for (int edit = 0; edit < editCount; edit++)
+        {
+            Cell cell{ rand() % size, rand() % size };
+            bool passable = !grid.Passable(cell);
+            if (!passable && connectivity.WouldDisconnect(cell))
+                continue;   // Refused, as the game would.
+            connectivity.SetPassable(cell, passable);
+            grid.SetPassable(cell, passable);
+        }
+        double editNs = ElapsedNs(begin);
+        size_t recomputes = connectivity.Recomputes() - recomputesBefore;
+        match = match && connectivity.Connected();
+
+        printf("  %4dx%-4d  build %12.0f ns  query %6.2f ns  naive %12.0f ns  edit %10.0f ns (%zu of %d recomputed)  %s\n",
+            size, size, buildNs, queryNs / queryCount, naiveNs / naiveCount, editNs / editCount, recomputes, editCount,
+            Verdict(match));
+    }
+}
+
+// -- BITBOARD ---------------------------------
+// Flood fill of the walkable region and "grass within range" counts on random tile maps, scalar
+// over 4-byte tiles (a closed-set BFS and a per-tile distance test) against the bitplanes. Both
+// must agree on every cell count.
+static void BenchBitboard()
+{
+    const int sizes[] = { 20, 256, 1024 };
+    const int queryCount = 256;
+    const float range = 6.0f;
+
+    printf("bitboard: 70%% road, fill from a road cell, grass within %.0f tiles\n", range);
+    for (int size : sizes)
+    {
+        srand(8);
+        std::vector<int> tiles((size_t)size * size);
+        TileBitboard board(size, size);
+        for (int row = 0; row < size; row++)
+        {
+            for (int col = 0; col < size; col++)
+            {
+                int roll = rand() % 10;
+                TileType type = roll < 7 ? DIRT : roll < 9 ? GRASS : TURRET;
+                tiles[row * size + col] = type;
+                board.Set({ row, col }, type);
+            }
+        }
+        Cell seed{ size / 2, size / 2 };
+        tiles[seed.row * size + seed.col] = DIRT;
+        board.Set(seed, DIRT);
+
+        std::vector<uint8_t> closed;
+        std::vector<Cell> open;
+        size_t scalarCount = 0;
+        double scalarFillNs = TimeNs([&]() {
+            closed.assign(tiles.size(), 0);
+            open.clear();
+            open.push_back(seed);
+            closed[seed.row * size + seed.col] = 1;
+            scalarCount = 0;
+            while (!open.empty())
+            {
+                Cell cell = open.back();
+                open.pop_back();
+                scalarCount++;
+                for (Cell dir : DIRECTIONS)
+                {
+                    Cell adj = { cell.row + dir.row, cell.col + dir.col };
+                    if (!InBounds(adj, size, size) || closed[adj.row * size + adj.col] || !IsWalkable(tiles[adj.row * size + adj.col]))
+                        continue;
+                    closed[adj.row * size + adj.col] = 1;
+                    open.push_back(adj);
+                }
+            }
+        });
+
+        BitGrid walkable;
+        BitGrid region;
+        board.Walkable(walkable);
+        double bitFillNs = TimeNs([&]() {
+            FloodFill(walkable, seed, region);
+        });
+        bool match = region.Count() == scalarCount;
+
+        std::vector<Cell> centers(queryCount);
+        for (Cell& cell : centers)
+            cell = { rand() % size, rand() % size };
+        std::vector<size_t> scalarHits(queryCount);
+        std::vector<size_t> bitHits(queryCount);
+        int reach = (int)range;
+        double scalarRangeNs = TimeNs([&]() {
+            for (int i = 0; i < queryCount; i++)
+            {
+                Cell center = centers[i];
+                size_t hits = 0;
+                for (int row = std::max(0, center.row - reach); row <= std::min(size - 1, center.row + reach); row++)
+                {
+                    for (int col = std::max(0, center.col - reach); col <= std::min(size - 1, center.col + reach); col++)
+                    {
+                        int dy = row - center.row;
+                        int dx = col - center.col;
+                        if ((float)(dx * dx + dy * dy) <= range * range && tiles[row * size + col] == GRASS)
+                            hits++;
+                    }
+                }
+                scalarHits[i] = hits;
+            }
+        });
+        double bitRangeNs = TimeNs([&]() {
+            for (int i = 0; i < queryCount; i++)
+                bitHits[i] = board.CountInRange(GRASS, centers[i], range);
+        });
+        match = match && scalarHits == bitHits;
+
+        printf("  %4dx%-4d  fill %12.0f -> %10.0f ns (%5.1fx)  range %9.0f -> %9.0f ns (%5.1fx)  memory %9zu -> %8zu bytes  %s\n",
+            size, size, scalarFillNs, bitFillNs, scalarFillNs / bitFillNs, scalarRangeNs / queryCount, bitRangeNs / queryCount,
+            scalarRangeNs / bitRangeNs, tiles.size() * sizeof(int), board.MemoryBytes(), Verdict(match));
+    }
+}
+
+// -- MAP LOADING ---------------------------------
+// Loading a random map from the text format against mapping the binary one. Files are written to the
+// working directory and removed afterwards; both are in the OS file cache, so this is the parse cost
+// alone. The loaded tiles are checked equal.
+static void BenchMapLoad()
+{
+    const int sizes[] = { 256, 1024, 4096 };
+    const char* textPath = "bench_map.txt";
+    const char* mapPath = "bench_map.tdmap";
+
+    printf("map loading: text parse against binary map, warm file cache\n");
+    for (int size : sizes)
+    {
+        srand(9);
+        TileGrid<> tiles(size, size);
+        for (int row = 0; row < size; row++)
+        {
+            for (int col = 0; col < size; col++)
+                tiles.Set({ row, col }, (TileType)(rand() % COUNT));
+        }
+        Cell spawn{ 0, 0 };
+        Cell goal{ size - 1, size - 1 };
+
+        FILE* file = fopen(textPath, "w");
+        if (!file)
+        {
+            printf("  can't write %s\n", textPath);
+            return;
+        }
+        fprintf(file, "spawn %d %d\ngoal %d %d\n", spawn.row, spawn.col, goal.row, goal.col);
+        for (int row = 0; row < size; row++)
+        {
+            fputs("{ ", file);
+            for (int col = 0; col < size; col++)
+                fprintf(file, col + 1 < size ? "%d, " : "%d },\n", tiles.Get(row, col));
+        }
+        fclose(file);
+        WriteMapFile(mapPath, tiles, spawn, goal);
+
+        TileGrid<> parsed;
+        Cell parsedSpawn;
+        Cell parsedGoal;
+        const char* error;
+        bool match = true;
+        double textNs = TimeNs([&]() {
+            match = ReadTextMap(textPath, parsed, parsedSpawn, parsedGoal, error) && match;
+        }, 0.5);
+        match = match && memcmp(parsed.Data(), tiles.Data(), (size_t)size * size) == 0;
+
+        MapFile map;
+        double mapNs = TimeNs([&]() {
+            match = map.Open(mapPath) && match;
+        }, 0.5);
+        match = match && map.Tiles().Rows() == size && memcmp(map.Tiles().Data(), tiles.Data(), (size_t)size * size) == 0;
+        map.Close();
+        remove(textPath);
+        remove(mapPath);
+
+        printf("  %4dx%-4d  text %12.0f ns  binary %10.0f ns  (%6.1fx)  %s\n",
+            size, size, textNs, mapNs, textNs / mapNs, Verdict(match));
+    }
+}
+
+// -- FLOW FIELD ---------------------------------
+// Goal flow field build on one thread and on every hardware thread, checked equal, plus the cost of
+// one enemy's per-tick lookup. The distance at the far corner is checked against A*.
+static void BenchFlowField()
+{
+    const int sizes[] = { 256, 1024, 2048 };
+    const size_t sampleCount = 1000000;
+
+    JobSystem serial(1);
+    JobSystem parallel(0);
+    printf("flow field: 20%% blocked, goal in the centre, %u threads\n", parallel.ThreadCount());
+    for (int size : sizes)
+    {
+        srand(4);
+        NavGrid grid(size, size);
+        for (int row = 0; row < size; row++)
+        {
+            for (int col = 0; col < size; col++)
+                grid.SetPassable({ row, col }, rand() % 5 != 0);
+        }
+        Cell goal{ size / 2, size / 2 };
+        Cell corner{ 0, 0 };
+        grid.SetPassable(goal, true);
+        grid.SetPassable(corner, true);
+
+        FlowField serialField;
+        FlowField parallelField;
+        double serialNs = TimeNs([&]() {
+            serialField.Build(grid, goal, &serial);
+        }, 0.5);
+        double parallelNs = TimeNs([&]() {
+            parallelField.Build(grid, goal, &parallel);
+        }, 0.5);
+
+        bool match = true;
+        for (int row = 0; row < size && match; row++)
+        {
+            for (int col = 0; col < size && match; col++)
+            {
+                Cell cell{ row, col };
+                Cell a = serialField.Next(cell);
+                Cell b = parallelField.Next(cell);
+                match = serialField.Distance(cell) == parallelField.Distance(cell) && a.row == b.row && a.col == b.col;
+            }
+        }
+        std::vector<Cell> route;
+        bool reachable = FindPathAStar(grid, corner, goal, route);
+        match = match && serialField.Distance(corner) == (reachable ? (int)route.size() - 1 : FlowField::UNREACHABLE);
+
+        std::vector<Cell> samples(sampleCount);
+        std::vector<Cell> targets(sampleCount);
+        for (Cell& cell : samples)
+            cell = { rand() % size, rand() % size };
+        double sampleNs = TimeNs([&]() {
+            for (size_t i = 0; i < sampleCount; i++)
+                targets[i] = parallelField.Next(samples[i]);
+        });
+
+        printf("  %4dx%-4d  build serial %12.0f ns  parallel %12.0f ns  speedup %5.2fx  lookup %5.2f ns/enemy  %s\n",
+            size, size, serialNs, parallelNs, serialNs / parallelNs, sampleNs / sampleCount, Verdict(match));
+    }
+}
+
+// -- CHUNKED TILES ---------------------------------
+// Keeping the tile layer of a large map current while a few tiles change per frame: rebuilding every
+// chunk against rebuilding only the chunks edited since the last frame.
+static void BenchChunks()
+{
+    const int size = 4096;
+    const int editsPerFrame = 16;
+    const int frames = 64;
+
+    srand(10);
+    TileGrid<> source(size, size);
+    for (int row = 0; row < size; row++)
+    {
+        for (int col = 0; col < size; col++)
+            source.Set({ row, col }, rand() % 8 == 0 ? DIRT : GRASS);
+    }
+    ChunkedTileMap tiles(source);
+
+    TileLayerCache full;
+    double fullNs = TimeNs([&]() {
+        TileLayerCache fresh;
+        fresh.Update(tiles);
+        full = std::move(fresh);
+    }, 1.0);
+
+    TileLayerCache incremental;
+    incremental.Update(tiles);
+    size_t rebuilt = 0;
+    auto begin = Clock::now();
+    for (int frame = 0; frame < frames; frame++)
+    {
+        for (int edit = 0; edit < editsPerFrame; edit++)
+        {
+            Cell cell{ rand() % size, rand() % size };
+            tiles.Set(cell, tiles.Get(cell) == GRASS ? DIRT : GRASS);
+        }
+        incremental.Update(tiles);
+        rebuilt += incremental.RebuiltChunks();
+    }
+    double incrementalNs = ElapsedNs(begin) / frames;
+
+    RenderList a;
+    RenderList b;
+    full.Update(tiles);
+    full.Emit(a, size, size);
+    incremental.Emit(b, size, size);
+
+    printf("chunked tiles: %dx%d, %d chunks, %d edits per frame\n", size, size, tiles.ChunkCount(), editsPerFrame);
+    printf("  full rebuild %12.0f ns  incremental %10.0f ns/frame (%5.1f chunks)  %zu rects  %s\n",
+        fullNs, incrementalNs, (double)rebuilt / frames, a.Commands().size(), Verdict(DiffFrames(a, b) == 0));
+
+    // A huge, mostly-grass map: a serpentine road (rows every 1024 tiles joined at alternating ends).
+    const int hugeSize = 16384;
+    ChunkedTileMap huge(hugeSize, hugeSize);
+    for (int row = 0; row < hugeSize; row += 1024)
+    {
+        for (int col = 0; col < hugeSize; col++)
+            huge.Set({ row, col }, DIRT);
+        int side = (row / 1024) % 2 == 0 ? hugeSize - 1 : 0;
+        for (int step = 1; step < 1024 && row + step < hugeSize; step++)
+            huge.Set({ row + step, side }, DIRT);
+    }
+    size_t encodings[CHUNK_ENCODING_COUNT] = {};
+    for (int chunk = 0; chunk < huge.ChunkCount(); chunk++)
+        encodings[huge.Encoding(chunk)]++;
+
+    const size_t readCount = 1000000;
+    std::vector<Cell> cells(readCount);
+    for (size_t i = 0; i < readCount; i++)
+    {
+        // Half the reads on the road rows, where chunks aren't uniform.
+        int row = i % 2 ? (rand() % 16) * 1024 : rand() % hugeSize;
+        cells[i] = { row, rand() % hugeSize };
+    }
+    size_t road = 0;
+    double readNs = TimeNs([&]() {
+        road = 0;
+        for (Cell cell : cells)
+            road += huge.Get(cell) == DIRT;
+    });
+    printf("  %dx%d road map: %.2f MB (one byte per tile: %.0f MB, int per tile: %.0f MB)  uniform %zu  palette %zu  runs %zu  raw %zu  read %.2f ns\n",
+        hugeSize, hugeSize, huge.MemoryBytes() / 1048576.0, (double)hugeSize * hugeSize / 1048576.0,
+        (double)hugeSize * hugeSize * sizeof(int) / 1048576.0, encodings[CHUNK_UNIFORM], encodings[CHUNK_PALETTE],
+        encodings[CHUNK_RUNS], encodings[CHUNK_RAW], readNs / readCount);
+}
+
+// -- LINE OF SIGHT ---------------------------------
+// Turret-to-enemy visibility on a rocky map: a DDA raycast per turret-enemy pair in range against one
+// bit test in each turret's precomputed mask, plus what a rock edit costs in mask rebuilds.
+static void BenchSight()
+{
+    const int size = 256;
+    const size_t turretCount = 2000;
+    const size_t enemyCount = 20000;
+    const float range = 250.0f;
+    const int edits = 256;
+
+    srand(12);
+    ChunkedTileMap tiles(size, size);
+    for (int row = 0; row < size; row++)
+    {
+        for (int col = 0; col < size; col++)
+        {
+            if (rand() % 8 == 0)
+                tiles.Set({ row, col }, ROCK);
+        }
+    }
+
+    std::vector<Cell> turrets(turretCount);
+    for (Cell& turret : turrets)
+        turret = { rand() % size, rand() % size };
+
+    // The pairs come from one spatial hash pass, so both timings below are the visibility check alone.
+    struct SightPair
+    {
+        int turret;
+        Cell enemy;
+    };
+    std::vector<Vector2> enemies = RandomPositions(enemyCount, size * TILE_SIZE);
+    SpatialHash grid(range * 0.5f);
+    grid.Begin(enemies.size());
+    for (size_t e = 0; e < enemies.size(); e++)
+        grid.Insert((int)e, enemies[e]);
+    grid.End();
+    std::vector<SightPair> pairs;
+    for (size_t t = 0; t < turretCount; t++)
+    {
+        grid.Query(TileCenter(turrets[t].row, turrets[t].col), range, [&](int, Vector2 position) {
+            pairs.push_back({ (int)t, TileAt(position) });
+        });
+    }
+
+    std::vector<VisibilityMask> masks(turretCount);
+    double buildNs = TimeNs([&]() {
+        for (size_t t = 0; t < turretCount; t++)
+            masks[t].Build(tiles, turrets[t], SightRadius(range));
+    }) / turretCount;
+
+    size_t rayVisible = 0;
+    double rayNs = TimeNs([&]() {
+        rayVisible = 0;
+        for (const SightPair& pair : pairs)
+            rayVisible += HasLineOfSight(tiles, turrets[pair.turret], pair.enemy);
+    });
+
+    size_t maskVisible = 0;
+    double maskNs = TimeNs([&]() {
+        maskVisible = 0;
+        for (const SightPair& pair : pairs)
+            maskVisible += masks[pair.turret].Visible(pair.enemy);
+    });
+
+    // Toggle rocks and rebuild just the masks whose square holds the tile, as Simulation::SetTile does.
+    size_t rebuilt = 0;
+    auto begin = Clock::now();
+    for (int edit = 0; edit < edits; edit++)
+    {
+        Cell cell{ rand() % size, rand() % size };
+        tiles.Set(cell, tiles.Get(cell) == ROCK ? GRASS : ROCK);
+        for (size_t t = 0; t < turretCount; t++)
+        {
+            if (masks[t].Covers(cell))
+            {
+                masks[t].Build(tiles, turrets[t], SightRadius(range));
+                rebuilt++;
+            }
+        }
+    }
+    double editNs = ElapsedNs(begin) / edits;
+
+    size_t stale = 0;
+    for (const SightPair& pair : pairs)
+        stale += masks[pair.turret].Visible(pair.enemy) != HasLineOfSight(tiles, turrets[pair.turret], pair.enemy);
+
+    printf("line of sight: %dx%d, 1 in 8 tiles rock, %zu turrets, %zu enemies, range %.0f\n",
+        size, size, turretCount, enemyCount, range);
+    printf("  %zu pairs in range, %zu visible  raycast %8.2f ns/pair  mask %6.2f ns/pair  speedup %5.2fx  %s\n",
+        pairs.size(), rayVisible, rayNs / pairs.size(), maskNs / pairs.size(), rayNs / maskNs,
+        Verdict(rayVisible == maskVisible));
+    printf("  mask build %8.0f ns  rock edit %8.0f ns (%4.1f masks rebuilt)  %s after edits\n",
+        buildNs, editNs, (double)rebuilt / edits, Verdict(stale == 0));
+}
+
+// -- RENDERING ---------------------------------
+// Command-list build time and draw call counts for the real level with a crowd of enemies,
+// measured through the recording backend so no GL context is needed.
+static void BenchRender()
+{
+    SimulationConfig config;
+    config.enemyTotal = 1000;
+    config.spawnStall = 0.0f;
+    Simulation simulation(LEVEL_TILES, LEVEL_SPAWN, LEVEL_GOAL, config);
+    for (int tick = 0; tick < 600; tick++)
+        simulation.Step(FIXED_DT);
+
+    RenderList list;
+    RecordingBackend backend;
+    TileLayerCache tileLayer;
+    double buildNs = TimeNs([&]() {
+        BuildFrame(simulation, { 0, 0 }, tileLayer, list);
+    });
+    backend.Submit(list);
+
+    RenderList previous = list;
+    simulation.Step(FIXED_DT);
+    BuildFrame(simulation, { 0, 0 }, tileLayer, list);
+
+    printf("render: %zu enemies, %zu bullets\n", simulation.Enemies().size(), simulation.Bullets().size());
+    printf("  build %10.0f ns  draw calls %zu (rect %zu, circle %zu, text %zu)  changed next tick %zu\n",
+        buildNs, backend.DrawCalls(), backend.CountOf(RENDER_RECTANGLE), backend.CountOf(RENDER_CIRCLE),
+        backend.CountOf(RENDER_TEXT), DiffFrames(previous, list));
+}
+
+int RunBenchmarks(int argc, char** argv)
+{
+    if (argc > 2 && strcmp(argv[2], "stress") == 0)
+    {
+        long long ticks = argc > 3 ? atoll(argv[3]) : 300;
+        unsigned threadCount = argc > 4 ? (unsigned)atoi(argv[4]) : 1;
+        return RunStressBenchmarks(ticks, threadCount, argc > 5 ? argv[5] : nullptr);
+    }
+
+    struct BenchCase
+    {
+        const char* name;
+        void (*run)();
+    };
+    const BenchCase cases[] = {
+        { "targeting", []() { BenchTargeting(SCREEN_SIZE); BenchTargeting(SCREEN_SIZE * 8); } },
+        { "movement", BenchMovement },
+        { "broadphase", BenchBroadphase },
+        { "kernels", BenchKernels },
+        { "precision", BenchPrecision },
+        { "trig", BenchTrig },
+        { "matrix", BenchMatrix },
+        { "quaternion", BenchQuaternion },
+        { "pathfinding", BenchPathfinding },
+        { "hpa", BenchHierarchical },
+        { "placement", BenchPlacement },
+        { "bitboard", BenchBitboard },
+        { "mapload", BenchMapLoad },
+        { "chunks", BenchChunks },
+        { "sight", BenchSight },
+        { "flowfield", BenchFlowField },
+        { "render", BenchRender },
+    };
+
+    // main --bench [case] runs one case by name; no name runs them all.
+    const char* only = argc > 2 ? argv[2] : nullptr;
+    bool found = false;
+    for (const BenchCase& bench : cases)
+    {
+        if (only && strcmp(only, bench.name) != 0)
+            continue;
+        bench.run();
+        found = true;
+    }
+    if (!found)
+    {
+        printf("unknown benchmark '%s'; cases:", only);
+        for (const BenchCase& bench : cases)
+            printf(" %s", bench.name);
+        printf(" stress\n");
+        return 1;
+    }
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+// Headless micro-benchmarks, run with: main --bench [case]
+// Prints one line per case so results can be compared between builds. Naming a case runs only that one.
+// main --bench stress [ticks] [threads] [scenario] runs the entity stress suite instead.
+int RunBenchmarks(int argc, char** argv);
+
+// Entity stress scenarios on the real level. Prints one JSON object per line per scenario with
+// ns/tick split by phase, entities/sec and peak simulation memory, for tracking regressions.
+// Naming a scenario runs only that one and adds the process's peak resident memory, which then
+// belongs to that scenario alone; run each in its own process for per-scenario RSS:
+//   for s in enemies_10k enemies_10k_flow turrets_1k bullets_100k mixed_wave; do main --bench stress 300 1 $s; done
+int RunStressBenchmarks(long long ticks, unsigned threadCount, const char* only = nullptr);
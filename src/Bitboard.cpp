@@ -0,0 +1,275 @@
+#include "Bitboard.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+int BitGrid::CountTrailingZeros(uint64_t word)
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, word);
+    return (int)index;
+#else
+    return __builtin_ctzll(word);
+#endif
+}
+
+static int PopCount(uint64_t word)
+{
+#if defined(_MSC_VER)
+    return (int)__popcnt64(word);
+#else
+    return __builtin_popcountll(word);
+#endif
+}
+
+BitGrid::BitGrid(int rows, int cols)
+    : rows(rows), cols(cols), wordsPerRow((cols + 63) / 64), words((size_t)rows * ((cols + 63) / 64), 0)
+{
+}
+
+void BitGrid::SetSpan(int row, int begin, int end)
+{
+    uint64_t* bits = Row(row);
+    while (begin < end)
+    {
+        int w = begin >> 6;
+        int last = std::min(end, (w + 1) * 64);
+        int length = last - begin;
+        uint64_t span = length == 64 ? ~uint64_t(0) : ((uint64_t(1) << length) - 1);
+        bits[w] |= span << (begin & 63);
+        begin = last;
+    }
+}
+
+void BitGrid::Clear()
+{
+    std::fill(words.begin(), words.end(), 0);
+}
+
+size_t BitGrid::Count() const
+{
+    size_t count = 0;
+    for (uint64_t word : words)
+        count += PopCount(word);
+    return count;
+}
+
+bool BitGrid::Any() const
+{
+    for (uint64_t word : words)
+    {
+        if (word)
+            return true;
+    }
+    return false;
+}
+
+BitGrid& BitGrid::operator&=(const BitGrid& other)
+{
+    for (size_t i = 0; i < words.size(); i++)
+        words[i] &= other.words[i];
+    return *this;
+}
+
+BitGrid& BitGrid::operator|=(const BitGrid& other)
+{
+    for (size_t i = 0; i < words.size(); i++)
+        words[i] |= other.words[i];
+    return *this;
+}
+
+BitGrid& BitGrid::AndNot(const BitGrid& other)
+{
+    for (size_t i = 0; i < words.size(); i++)
+        words[i] &= ~other.words[i];
+    return *this;
+}
+
+// Occluded fills: spread the set bits of x through consecutive bits of m, towards higher columns
+// or lower ones. Each step doubles the distance covered, so six steps span the whole word.
+static uint64_t FillHigher(uint64_t x, uint64_t m)
+{
+    x |= m & (x << 1);
+    m &= m << 1;
+    x |= m & (x << 2);
+    m &= m << 2;
+    x |= m & (x << 4);
+    m &= m << 4;
+    x |= m & (x << 8);
+    m &= m << 8;
+    x |= m & (x << 16);
+    m &= m << 16;
+    x |= m & (x << 32);
+    return x;
+}
+
+static uint64_t FillLower(uint64_t x, uint64_t m)
+{
+    x |= m & (x >> 1);
+    m &= m >> 1;
+    x |= m & (x >> 2);
+    m &= m >> 2;
+    x |= m & (x >> 4);
+    m &= m >> 4;
+    x |= m & (x >> 8);
+    m &= m >> 8;
+    x |= m & (x >> 16);
+    m &= m >> 16;
+    x |= m & (x >> 32);
+    return x;
+}
+
+void FloodFill(const BitGrid& mask, Cell seed, BitGrid& region)
+{
+    if (region.Rows() != mask.Rows() || region.Cols() != mask.Cols())
+        region = BitGrid(mask.Rows(), mask.Cols());
+    region.Clear();
+    if (!InBounds(seed, mask.Rows(), mask.Cols()) || !mask.Test(seed))
+        return;
+
+    int rows = mask.Rows();
+    int stride = mask.WordsPerRow();
+    const uint64_t* maskWords = mask.Row(0);
+    uint64_t* regionWords = region.Row(0);
+    int first = seed.row * stride + (seed.col >> 6);
+    regionWords[first] = FillLower(FillHigher(uint64_t(1) << (seed.col & 63), maskWords[first]), maskWords[first]);
+    std::vector<int> pending;
+    pending.push_back(first);
+    while (!pending.empty())
+    {
+        int i = pending.back();
+        pending.pop_back();
+        int row = i / stride;
+        int w = i - row * stride;
+        uint64_t m = maskWords[i];
+        uint64_t x = regionWords[i];
+        if (row > 0)
+            x |= regionWords[i - stride] & m;
+        if (row < rows - 1)
+            x |= regionWords[i + stride] & m;
+        if (w > 0)
+            x |= (regionWords[i - 1] >> 63) & m;
+        if (w < stride - 1)
+            x |= (regionWords[i + 1] << 63) & m;
+        regionWords[i] = x = FillLower(FillHigher(x, m), m);
+
+        // Only neighbours that can take in something new are revisited.
+        if (row > 0 && (x & maskWords[i - stride] & ~regionWords[i - stride]))
+            pending.push_back(i - stride);
+        if (row < rows - 1 && (x & maskWords[i + stride] & ~regionWords[i + stride]))
+            pending.push_back(i + stride);
+        if (w > 0 && (x & 1) && (maskWords[i - 1] >> 63) && !(regionWords[i - 1] >> 63))
+            pending.push_back(i - 1);
+        if (w < stride - 1 && (x >> 63) && (maskWords[i + 1] & 1) && !(regionWords[i + 1] & 1))
+            pending.push_back(i + 1);
+    }
+}
+
+// Bits [begin, end) of word w, for a span of columns.
+static uint64_t SpanBits(int w, int begin, int end)
+{
+    int low = std::max(begin - w * 64, 0);
+    int high = std::min(end - w * 64, 64);
+    if (low >= high)
+        return 0;
+    uint64_t upTo = high == 64 ? ~uint64_t(0) : (uint64_t(1) << high) - 1;
+    return upTo & ~((uint64_t(1) << low) - 1);
+}
+
+// Calls fn(row, word index, span bits) for each word overlapping the disk's column span in each row.
+template<typename Fn>
+static void ForEachDiskWord(int rows, int cols, Cell center, float radius, Fn&& fn)
+{
+    if (radius < 0.0f)
+        return;
+    int reach = (int)radius;
+    int first = std::max(0, center.row - reach);
+    int last = std::min(rows - 1, center.row + reach);
+    for (int row = first; row <= last; row++)
+    {
+        int dy = row - center.row;
+        int half = (int)std::sqrt(radius * radius - (float)(dy * dy));
+        int begin = std::max(0, center.col - half);
+        int end = std::min(cols, center.col + half + 1);
+        for (int w = begin >> 6; begin < end && w <= (end - 1) >> 6; w++)
+            fn(row, w, SpanBits(w, begin, end));
+    }
+}
+
+TileBitboard::TileBitboard(int rows, int cols, TileType fill)
+{
+    for (BitGrid& plane : planes)
+        plane = BitGrid(rows, cols);
+    for (int row = 0; row < rows; row++)
+        planes[fill].SetSpan(row, 0, cols);
+}
+
+TileBitboard::TileBitboard(TileView tiles)
+{
+    for (BitGrid& plane : planes)
+        plane = BitGrid(tiles.Rows(), tiles.Cols());
+    for (int row = 0; row < tiles.Rows(); row++)
+    {
+        for (int col = 0; col < tiles.Cols(); col++)
+            planes[tiles.Get(row, col)].Set({ row, col }, true);
+    }
+}
+
+TileType TileBitboard::Get(Cell cell) const
+{
+    for (int type = 0; type < COUNT; type++)
+    {
+        if (planes[type].Test(cell))
+            return (TileType)type;
+    }
+    return GRASS;
+}
+
+void TileBitboard::Set(Cell cell, TileType type)
+{
+    for (int plane = 0; plane < COUNT; plane++)
+        planes[plane].Set(cell, plane == type);
+}
+
+void TileBitboard::Walkable(BitGrid& out) const
+{
+    out = planes[DIRT];
+    out |= planes[WAYPOINT];
+}
+
+size_t TileBitboard::CountInRange(TileType type, Cell center, float radius) const
+{
+    const BitGrid& plane = planes[type];
+    size_t count = 0;
+    ForEachDiskWord(Rows(), Cols(), center, radius, [&](int row, int w, uint64_t span) {
+        count += PopCount(plane.Row(row)[w] & span);
+    });
+    return count;
+}
+
+void TileBitboard::BuildableInRange(Cell center, float radius, std::vector<Cell>& cells) const
+{
+    cells.clear();
+    const BitGrid& plane = planes[GRASS];
+    ForEachDiskWord(Rows(), Cols(), center, radius, [&](int row, int w, uint64_t span) {
+        uint64_t word = plane.Row(row)[w] & span;
+        while (word)
+        {
+            cells.push_back({ row, w * 64 + BitGrid::CountTrailingZeros(word) });
+            word &= word - 1;
+        }
+    });
+}
+
+size_t TileBitboard::MemoryBytes() const
+{
+    size_t bytes = 0;
+    for (const BitGrid& plane : planes)
+        bytes += plane.MemoryBytes();
+    return bytes;
+}
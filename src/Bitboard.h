@@ -0,0 +1,106 @@
+#pragma once
+#include "Grid.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// One bit per cell, each row padded to whole 64-bit words. Bit c % 64 of word c / 64 is column c;
+// padding bits are always zero, so whole-word set operations and counts need no masking.
+class BitGrid
+{
+public:
+    BitGrid() = default;
+    BitGrid(int rows, int cols);
+
+    int Rows() const { return rows; }
+    int Cols() const { return cols; }
+    int WordsPerRow() const { return wordsPerRow; }
+
+    bool Test(Cell cell) const { return (words[cell.row * wordsPerRow + (cell.col >> 6)] >> (cell.col & 63)) & 1; }
+    void Set(Cell cell, bool value)
+    {
+        uint64_t& word = words[cell.row * wordsPerRow + (cell.col >> 6)];
+        uint64_t bit = uint64_t(1) << (cell.col & 63);
+        word = value ? word | bit : word & ~bit;
+    }
+
+    // Sets columns [begin, end) of one row.
+    void SetSpan(int row, int begin, int end);
+
+    void Clear();
+    size_t Count() const;
+    bool Any() const;
+
+    // Set operations with a grid of the same size.
+    BitGrid& operator&=(const BitGrid& other);
+    BitGrid& operator|=(const BitGrid& other);
+    BitGrid& AndNot(const BitGrid& other);
+
+    // Calls fn(Cell) for every set bit in row-major order.
+    template<typename Fn>
+    void ForEach(Fn&& fn) const
+    {
+        for (int row = 0; row < rows; row++)
+        {
+            for (int w = 0; w < wordsPerRow; w++)
+            {
+                uint64_t word = words[row * wordsPerRow + w];
+                while (word)
+                {
+                    fn(Cell{ row, w * 64 + CountTrailingZeros(word) });
+                    word &= word - 1;
+                }
+            }
+        }
+    }
+
+    const uint64_t* Row(int row) const { return &words[row * wordsPerRow]; }
+    uint64_t* Row(int row) { return &words[row * wordsPerRow]; }
+    size_t MemoryBytes() const { return words.capacity() * sizeof(uint64_t); }
+
+    static int CountTrailingZeros(uint64_t word);
+
+private:
+    int rows = 0;
+    int cols = 0;
+    int wordsPerRow = 0;
+    std::vector<uint64_t> words;
+};
+
+// Cells of mask 4-connected to seed through mask, by shift-and-mask dilation one 64-cell word at a
+// time: a word pulls in the masked bits of the words above, below and beside it, then fills
+// sideways through its mask runs in log2(64) shifts. Words that grew push the neighbours they can
+// spread into onto a worklist. Region comes out empty if the seed is outside the mask.
+void FloodFill(const BitGrid& mask, Cell seed, BitGrid& region);
+
+// A bitplane per TileType, so "which tiles are X" is a plane and compound queries are word-wide
+// set operations instead of per-tile compares. Exactly one plane has each cell set.
+class TileBitboard
+{
+public:
+    TileBitboard() = default;
+    TileBitboard(int rows, int cols, TileType fill = GRASS);
+    explicit TileBitboard(TileView tiles);
+
+    int Rows() const { return planes[0].Rows(); }
+    int Cols() const { return planes[0].Cols(); }
+
+    TileType Get(Cell cell) const;
+    void Set(Cell cell, TileType type);
+
+    const BitGrid& Plane(TileType type) const { return planes[type]; }
+
+    // DIRT | WAYPOINT, the cells enemies can walk on.
+    void Walkable(BitGrid& out) const;
+
+    // Range queries over tiles whose centres are within radius tiles of the cell's centre. Only the
+    // words overlapping the disk are read, masked to its span in each row.
+    size_t CountInRange(TileType type, Cell center, float radius) const;
+    void BuildableInRange(Cell center, float radius, std::vector<Cell>& cells) const;
+
+    size_t MemoryBytes() const;
+
+private:
+    BitGrid planes[COUNT];
+};
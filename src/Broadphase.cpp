@@ -0,0 +1,131 @@
+#include "Broadphase.h"
+
+#include <algorithm>
+
+void SweepAndPrune::Grow(int layer, int count)
+{
+    for (int index = (int)proxies[layer].size(); index < count; index++)
+        proxies[layer].push_back({ 0.0f, 0.0f, 0.0f, 0.0f, index });
+}
+
+void SweepAndPrune::Remap(int layer, const std::vector<int>& remap)
+{
+    std::vector<Proxy>& layerProxies = proxies[layer];
+    size_t write = 0;
+    for (size_t read = 0; read < layerProxies.size(); read++)
+    {
+        Proxy proxy = layerProxies[read];
+        proxy.index = remap[proxy.index];
+        if (proxy.index >= 0)
+            layerProxies[write++] = proxy;
+    }
+    layerProxies.resize(write);
+}
+
+void SweepAndPrune::Sort(std::vector<Proxy>& layer, bool stale)
+{
+    if (stale)
+    {
+        std::sort(layer.begin(), layer.end(), [](const Proxy& lhs, const Proxy& rhs) { return lhs.minX < rhs.minX; });
+        return;
+    }
+
+    // Insertion sort: the order from last tick is almost correct, so each proxy moves a few slots at most.
+    for (size_t i = 1; i < layer.size(); i++)
+    {
+        Proxy proxy = layer[i];
+        size_t j = i;
+        while (j > 0 && layer[j - 1].minX > proxy.minX)
+        {
+            layer[j] = layer[j - 1];
+            j--;
+        }
+        layer[j] = proxy;
+    }
+}
+
+void SweepAndPrune::FindPairs(std::vector<BroadphasePair>& pairs)
+{
+    pairs.clear();
+    if (proxies[0].empty() || proxies[1].empty())
+        return;
+
+    // Merge the two sorted layers. Each proxy, as the sweep reaches it, drops the other layer's
+    // proxies that ended before it starts and pairs with the rest, whose x-intervals all contain its
+    // minX. Its own layer's active list is never searched, so same-layer overlaps are free.
+    active[0].clear();
+    active[1].clear();
+    size_t next[LAYER_COUNT] = {};
+    for (;;)
+    {
+        bool more0 = next[0] < proxies[0].size();
+        bool more1 = next[1] < proxies[1].size();
+        int layer = !more0 || (more1 && proxies[1][next[1]].minX < proxies[0][next[0]].minX) ? 1 : 0;
+        int other = 1 - layer;
+        if (next[layer] == proxies[layer].size() || (active[other].empty() && next[other] == proxies[other].size()))
+            break;
+
+        const Proxy& proxy = proxies[layer][next[layer]++];
+        std::vector<Proxy>& open = active[other];
+        for (size_t i = 0; i < open.size();)
+        {
+            if (open[i].maxX < proxy.minX)
+            {
+                open[i] = open.back();
+                open.pop_back();
+            }
+            else
+            {
+                i++;
+            }
+        }
+
+        // Every open proxy overlaps in x; write each one's pair and keep it if y overlaps too,
+        // which avoids a hard-to-predict branch per candidate.
+        size_t count = pairs.size();
+        pairs.resize(count + open.size());
+        for (const Proxy& candidate : open)
+        {
+            BroadphasePair& pair = pairs[count];
+            pair.a = layer == 0 ? proxy.index : candidate.index;
+            pair.b = layer == 0 ? candidate.index : proxy.index;
+            count += proxy.minY <= candidate.maxY && candidate.minY <= proxy.maxY;
+        }
+        pairs.resize(count);
+        active[layer].push_back(proxy);
+    }
+
+    // Sweep order depends on positions; sort so the narrowphase resolves hits in array order. A
+    // counting sort on the first-layer index, then an insertion sort within each one's few pairs.
+    starts.assign(proxies[0].size() + 1, 0);
+    for (const BroadphasePair& pair : pairs)
+        starts[pair.a + 1]++;
+    for (size_t a = 1; a < starts.size(); a++)
+        starts[a] += starts[a - 1];
+    sorted.resize(pairs.size());
+    for (const BroadphasePair& pair : pairs)
+        sorted[starts[pair.a]++] = pair;
+    for (size_t begin = 0, end; begin < sorted.size(); begin = end)
+    {
+        for (end = begin + 1; end < sorted.size() && sorted[end].a == sorted[begin].a; end++)
+        {
+            BroadphasePair pair = sorted[end];
+            size_t j = end;
+            while (j > begin && sorted[j - 1].b > pair.b)
+            {
+                sorted[j] = sorted[j - 1];
+                j--;
+            }
+            sorted[j] = pair;
+        }
+    }
+    pairs.swap(sorted);
+}
+
+size_t SweepAndPrune::MemoryBytes() const
+{
+    size_t bytes = 0;
+    for (int layer = 0; layer < LAYER_COUNT; layer++)
+        bytes += (proxies[layer].capacity() + active[layer].capacity()) * sizeof(Proxy);
+    return bytes + starts.capacity() * sizeof(int) + sorted.capacity() * sizeof(BroadphasePair);
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+// Candidate pair from the broadphase: object `a` on the first layer overlaps object `b` on the second.
+struct BroadphasePair
+{
+    int a;
+    int b;
+};
+
+// Sweep-and-prune over two layers of objects (e.g. bullets and enemies), each layer sorted on
+// minimum x. The sorted order is kept between ticks and repaired with an insertion sort, which is
+// close to linear when objects only move a little per tick. The two layers are swept against each
+// other by merging them, so overlaps within a layer cost nothing. Objects are addressed by their
+// index in the caller's array; Grow and Remap keep the proxies in step as those arrays change.
+class SweepAndPrune
+{
+public:
+    static const int LAYER_COUNT = 2;
+
+    // Adds proxies for objects [known count, count) that were appended to a layer.
+    void Grow(int layer, int count);
+
+    // Renumbers a layer after the caller compacted its array. remap[old index] is the new
+    // index, or -1 if the object was removed. Sorted order of the survivors is preserved.
+    void Remap(int layer, const std::vector<int>& remap);
+
+    // Refreshes every proxy's bounds. bounds(layer, index, minX, maxX, minY, maxY) fills the box.
+    // Does nothing while a layer is empty, since no pair can come out of FindPairs then; the next
+    // Update after that sorts from scratch rather than repairing a long-stale order.
+    template<typename BoundsFn>
+    void Update(BoundsFn&& bounds);
+
+    // Writes every first-layer/second-layer pair whose boxes overlap, sorted by (a, b).
+    void FindPairs(std::vector<BroadphasePair>& pairs);
+
+    size_t ProxyCount() const { return proxies[0].size() + proxies[1].size(); }
+    size_t MemoryBytes() const;
+
+private:
+    struct Proxy
+    {
+        float minX;
+        float maxX;
+        float minY;
+        float maxY;
+        int index;
+    };
+
+    static void Sort(std::vector<Proxy>& layer, bool stale);
+
+    std::vector<Proxy> proxies[LAYER_COUNT];    // Per layer, sorted on minX after Update.
+    bool stale = false;                         // Updates were skipped, so the order may be far off.
+    // FindPairs scratch.
+    std::vector<Proxy> active[LAYER_COUNT];     // Copies of the proxies whose x-interval is still open.
+    std::vector<int> starts;                    // Counting sort: first output slot per first-layer index.
+    std::vector<BroadphasePair> sorted;
+};
+
+template<typename BoundsFn>
+void SweepAndPrune::Update(BoundsFn&& bounds)
+{
+    if (proxies[0].empty() || proxies[1].empty())
+    {
+        stale = true;
+        return;
+    }
+    for (int layer = 0; layer < LAYER_COUNT; layer++)
+    {
+        for (Proxy& proxy : proxies[layer])
+            bounds(layer, proxy.index, proxy.minX, proxy.maxX, proxy.minY, proxy.maxY);
+        Sort(proxies[layer], stale);
+    }
+    stale = false;
+}
@@ -0,0 +1,259 @@
+#include "ChunkedTileMap.h"
+
+#include <algorithm>
+#include <cstring>
+
+// CHUNK_RUNS layout: CHUNK_SIZE + 1 uint16 run indices (row r's runs are [start[r], start[r + 1])),
+// then two bytes per run: first column, tile.
+static const int RUN_INDEX_BYTES = (CHUNK_SIZE + 1) * sizeof(uint16_t);
+
+// CHUNK_PALETTE layout: entry count, the entries, then the packed indices, low bits first.
+static int PaletteBits(int entries)
+{
+    return entries <= 2 ? 1 : entries <= 4 ? 2 : entries <= 16 ? 4 : 8;
+}
+
+static uint16_t RunStart(const uint8_t* data, int row)
+{
+    uint16_t start;
+    memcpy(&start, data + row * sizeof(uint16_t), sizeof(start));
+    return start;
+}
+
+ChunkedTileMap::ChunkedTileMap(TileView source)
+    : ChunkedTileMap(source.Rows(), source.Cols())
+{
+    uint8_t tiles[CHUNK_TILES];
+    for (int chunk = 0; chunk < ChunkCount(); chunk++)
+    {
+        ChunkRect bounds = ChunkBounds(chunk);
+        memset(tiles, GRASS, sizeof(tiles));
+        for (int row = 0; row < bounds.rows; row++)
+            memcpy(tiles + row * CHUNK_SIZE, source.Data() + (size_t)(bounds.row + row) * cols + bounds.col, bounds.cols);
+        Encode(tiles, chunks[chunk]);
+    }
+}
+
+ChunkedTileMap::ChunkedTileMap(int rows, int cols, TileType fill)
+    : rows(rows), cols(cols), chunksDown((rows + CHUNK_SIZE - 1) >> CHUNK_SHIFT), chunksAcross((cols + CHUNK_SIZE - 1) >> CHUNK_SHIFT)
+{
+    chunks.resize(ChunkCount());
+    for (Chunk& chunk : chunks)
+        chunk.value = (uint8_t)fill;
+}
+
+void ChunkedTileMap::Encode(const uint8_t* tiles, Chunk& chunk)
+{
+    bool present[256] = {};
+    uint8_t palette[256];
+    int entries = 0;
+    int runs = 0;
+    for (int i = 0; i < CHUNK_TILES; i++)
+    {
+        if (!present[tiles[i]])
+        {
+            present[tiles[i]] = true;
+            palette[entries++] = tiles[i];
+        }
+        if ((i & (CHUNK_SIZE - 1)) == 0 || tiles[i] != tiles[i - 1])
+            runs++;
+    }
+
+    chunk.data.reset();
+    chunk.size = 0;
+    if (entries == 1)
+    {
+        chunk.encoding = CHUNK_UNIFORM;
+        chunk.value = tiles[0];
+        return;
+    }
+
+    int bits = PaletteBits(entries);
+    int paletteBytes = bits < 8 ? 1 + entries + CHUNK_TILES * bits / 8 : CHUNK_TILES + 1;
+    int runBytes = RUN_INDEX_BYTES + 2 * runs;
+    if (paletteBytes <= runBytes && paletteBytes <= CHUNK_TILES)
+    {
+        uint8_t index[256];
+        for (int entry = 0; entry < entries; entry++)
+            index[palette[entry]] = (uint8_t)entry;
+        chunk.encoding = CHUNK_PALETTE;
+        chunk.value = (uint8_t)bits;
+        chunk.size = (uint16_t)paletteBytes;
+        chunk.data.reset(new uint8_t[paletteBytes]());
+        chunk.data[0] = (uint8_t)entries;
+        memcpy(&chunk.data[1], palette, entries);
+        uint8_t* packed = &chunk.data[1 + entries];
+        for (int i = 0; i < CHUNK_TILES; i++)
+            packed[(i * bits) >> 3] |= (uint8_t)(index[tiles[i]] << ((i * bits) & 7));
+    }
+    else if (runBytes <= CHUNK_TILES)
+    {
+        chunk.encoding = CHUNK_RUNS;
+        chunk.size = (uint16_t)runBytes;
+        chunk.data.reset(new uint8_t[runBytes]);
+        uint8_t* run = &chunk.data[RUN_INDEX_BYTES];
+        uint16_t start = 0;
+        for (int row = 0; row < CHUNK_SIZE; row++)
+        {
+            memcpy(&chunk.data[row * sizeof(uint16_t)], &start, sizeof(start));
+            const uint8_t* line = tiles + row * CHUNK_SIZE;
+            for (int col = 0; col < CHUNK_SIZE; col++)
+            {
+                if (col == 0 || line[col] != line[col - 1])
+                {
+                    *run++ = (uint8_t)col;
+                    *run++ = line[col];
+                    start++;
+                }
+            }
+        }
+        memcpy(&chunk.data[CHUNK_SIZE * sizeof(uint16_t)], &start, sizeof(start));
+    }
+    else
+    {
+        chunk.encoding = CHUNK_RAW;
+        chunk.size = (uint16_t)CHUNK_TILES;
+        chunk.data.reset(new uint8_t[CHUNK_TILES]);
+        memcpy(chunk.data.get(), tiles, CHUNK_TILES);
+    }
+}
+
+uint8_t ChunkedTileMap::Read(const Chunk& chunk, int row, int col)
+{
+    const uint8_t* data = chunk.data.get();
+    switch (chunk.encoding)
+    {
+    case CHUNK_UNIFORM:
+        return chunk.value;
+    case CHUNK_PALETTE:
+    {
+        int bits = chunk.value;
+        int bit = (row * CHUNK_SIZE + col) * bits;
+        int entry = (data[1 + data[0] + (bit >> 3)] >> (bit & 7)) & ((1 << bits) - 1);
+        return data[1 + entry];
+    }
+    case CHUNK_RUNS:
+    {
+        // The last run in the row starting at or before the column; rows hold at most CHUNK_SIZE runs.
+        const uint8_t* runs = data + RUN_INDEX_BYTES;
+        int run = RunStart(data, row);
+        int end = RunStart(data, row + 1);
+        while (run + 1 < end && runs[2 * (run + 1)] <= col)
+            run++;
+        return runs[2 * run + 1];
+    }
+    default:
+        return data[row * CHUNK_SIZE + col];
+    }
+}
+
+TileType ChunkedTileMap::Get(int row, int col) const
+{
+    const Chunk& chunk = chunks[(row >> CHUNK_SHIFT) * chunksAcross + (col >> CHUNK_SHIFT)];
+    return (TileType)Read(chunk, row & (CHUNK_SIZE - 1), col & (CHUNK_SIZE - 1));
+}
+
+void ChunkedTileMap::DecodeChunk(int index, uint8_t* tiles) const
+{
+    const Chunk& chunk = chunks[index];
+    const uint8_t* data = chunk.data.get();
+    switch (chunk.encoding)
+    {
+    case CHUNK_UNIFORM:
+        memset(tiles, chunk.value, CHUNK_TILES);
+        break;
+    case CHUNK_PALETTE:
+    {
+        int bits = chunk.value;
+        int mask = (1 << bits) - 1;
+        const uint8_t* packed = data + 1 + data[0];
+        for (int i = 0; i < CHUNK_TILES; i++)
+            tiles[i] = data[1 + ((packed[(i * bits) >> 3] >> ((i * bits) & 7)) & mask)];
+        break;
+    }
+    case CHUNK_RUNS:
+    {
+        const uint8_t* runs = data + RUN_INDEX_BYTES;
+        for (int row = 0; row < CHUNK_SIZE; row++)
+        {
+            int end = RunStart(data, row + 1);
+            for (int run = RunStart(data, row); run < end; run++)
+            {
+                int last = run + 1 < end ? runs[2 * (run + 1)] : CHUNK_SIZE;
+                memset(tiles + row * CHUNK_SIZE + runs[2 * run], runs[2 * run + 1], last - runs[2 * run]);
+            }
+        }
+        break;
+    }
+    default:
+        memcpy(tiles, data, CHUNK_TILES);
+        break;
+    }
+}
+
+bool ChunkedTileMap::Set(Cell cell, TileType type)
+{
+    int index = ChunkOf(cell);
+    Chunk& chunk = chunks[index];
+    int row = cell.row & (CHUNK_SIZE - 1);
+    int col = cell.col & (CHUNK_SIZE - 1);
+    if (Read(chunk, row, col) == (uint8_t)type)
+        return false;
+
+    uint8_t tiles[CHUNK_TILES];
+    DecodeChunk(index, tiles);
+    tiles[row * CHUNK_SIZE + col] = (uint8_t)type;
+    Encode(tiles, chunk);
+
+    chunk.version = ++version;
+    log.push_back(index);
+
+    // Keeping a chunk-count or two of history covers any consumer that looks at least that often.
+    size_t limit = 2 * (size_t)ChunkCount() + 64;
+    if (log.size() > limit)
+    {
+        size_t drop = log.size() - limit / 2;
+        logStart += drop;
+        log.erase(log.begin(), log.begin() + drop);
+    }
+    return true;
+}
+
+ChunkRect ChunkedTileMap::ChunkBounds(int chunk) const
+{
+    int row = (chunk / chunksAcross) * CHUNK_SIZE;
+    int col = (chunk % chunksAcross) * CHUNK_SIZE;
+    return { row, col, std::min(CHUNK_SIZE, rows - row), std::min(CHUNK_SIZE, cols - col) };
+}
+
+void ChunkedTileMap::ChangedSince(uint64_t since, std::vector<int>& changed) const
+{
+    changed.clear();
+    if (since >= version)
+        return;
+
+    if (since >= logStart)
+    {
+        // A chunk's latest entry is the one carrying its current version, so each is listed once.
+        for (size_t i = (size_t)(since - logStart); i < log.size(); i++)
+        {
+            if (chunks[log[i]].version == logStart + 1 + i)
+                changed.push_back(log[i]);
+        }
+        return;
+    }
+
+    for (int chunk = 0; chunk < ChunkCount(); chunk++)
+    {
+        if (chunks[chunk].version > since)
+            changed.push_back(chunk);
+    }
+}
+
+size_t ChunkedTileMap::MemoryBytes() const
+{
+    size_t bytes = chunks.capacity() * sizeof(Chunk) + log.capacity() * sizeof(int);
+    for (const Chunk& chunk : chunks)
+        bytes += chunk.size;
+    return bytes;
+}
@@ -0,0 +1,101 @@
+#pragma once
+#include "Grid.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Chunks are CHUNK_SIZE tiles square. A map that isn't a multiple of it has partial chunks along its
+// bottom and right edges, stored as if the missing tiles were GRASS.
+const int CHUNK_SHIFT = 5;
+const int CHUNK_SIZE = 1 << CHUNK_SHIFT;
+const int CHUNK_TILES = CHUNK_SIZE * CHUNK_SIZE;
+
+// How a chunk's tiles are stored. Each chunk takes whichever is smallest for its contents.
+enum ChunkEncoding : uint8_t
+{
+    CHUNK_UNIFORM,      // Every tile the same: no storage beyond the chunk record.
+    CHUNK_PALETTE,      // Distinct tiles listed once, each tile a 1, 2 or 4-bit index into the list.
+    CHUNK_RUNS,         // Runs of equal tiles per row, with each row's first run indexed.
+    CHUNK_RAW,          // One byte per tile.
+    CHUNK_ENCODING_COUNT
+};
+
+// Tiles covered by one chunk, clipped to the map.
+struct ChunkRect
+{
+    int row;
+    int col;
+    int rows;
+    int cols;
+};
+
+// A map's tiles stored chunk by chunk, each chunk compressed on its own, so a mostly-grass map costs
+// little more than its chunk records. Reads decode in place: a uniform chunk returns its one value,
+// a palette chunk extracts a bit field, a run chunk searches one row's few runs. An edit decodes its
+// chunk, changes the tile and re-encodes it.
+//
+// Every edit bumps the map version and stamps its chunk with it. A consumer (a render cache, a path
+// graph, a coverage mask) remembers the version it last built from and asks for the chunks changed
+// since, so it rebuilds only those. Any number of consumers can each keep their own version.
+class ChunkedTileMap
+{
+public:
+    ChunkedTileMap() = default;
+    explicit ChunkedTileMap(TileView tiles);
+    ChunkedTileMap(int rows, int cols, TileType fill = GRASS);
+
+    int Rows() const { return rows; }
+    int Cols() const { return cols; }
+    bool Contains(Cell cell) const { return InBounds(cell, rows, cols); }
+
+    TileType Get(int row, int col) const;
+    TileType Get(Cell cell) const { return Get(cell.row, cell.col); }
+
+    // All CHUNK_TILES tiles of a chunk, row-major; tiles past the map edge read as GRASS.
+    void DecodeChunk(int chunk, uint8_t* tiles) const;
+    ChunkEncoding Encoding(int chunk) const { return chunks[chunk].encoding; }
+
+    // Returns false, and leaves the version alone, if the tile is already that type.
+    bool Set(Cell cell, TileType type);
+
+    int ChunksDown() const { return chunksDown; }
+    int ChunksAcross() const { return chunksAcross; }
+    int ChunkCount() const { return chunksDown * chunksAcross; }
+    int ChunkOf(Cell cell) const { return (cell.row >> CHUNK_SHIFT) * chunksAcross + (cell.col >> CHUNK_SHIFT); }
+    ChunkRect ChunkBounds(int chunk) const;
+
+    // 0 for the map as constructed, +1 per edit.
+    uint64_t Version() const { return version; }
+    // Version of the chunk's last edit, 0 if it has never changed.
+    uint64_t ChunkVersion(int chunk) const { return chunks[chunk].version; }
+
+    // Every chunk edited after the given version, each once. O(edits since) while the edit log
+    // still reaches back that far, otherwise one pass over the chunk versions.
+    void ChangedSince(uint64_t since, std::vector<int>& changed) const;
+
+    size_t MemoryBytes() const;
+
+private:
+    struct Chunk
+    {
+        uint64_t version = 0;
+        ChunkEncoding encoding = CHUNK_UNIFORM;
+        uint8_t value = GRASS;              // UNIFORM: the tile. PALETTE: bits per tile.
+        uint16_t size = 0;                  // Bytes in data.
+        std::unique_ptr<uint8_t[]> data;
+    };
+
+    static void Encode(const uint8_t* tiles, Chunk& chunk);
+    static uint8_t Read(const Chunk& chunk, int row, int col);
+
+    int rows = 0;
+    int cols = 0;
+    int chunksDown = 0;
+    int chunksAcross = 0;
+    uint64_t version = 0;
+    std::vector<Chunk> chunks;
+    std::vector<int> log;               // Chunk of each edit after logStart; entry i is version logStart + 1 + i.
+    uint64_t logStart = 0;              // Trimmed forward once the log outgrows the chunk count.
+};
@@ -0,0 +1,249 @@
+#include "Connectivity.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+Connectivity::Connectivity(NavGrid grid, Cell source, Cell target)
+    : grid(std::move(grid)), source(source), target(target)
+{
+    int rows = this->grid.Rows();
+    int cols = this->grid.Cols();
+    auto onEdge = [&](Cell cell) {
+        return this->grid.Contains(cell) && (cell.row == 0 || cell.col == 0 || cell.row == rows - 1 || cell.col == cols - 1);
+    };
+    edgeEnds = onEdge(source) && onEdge(target) && (source.row != target.row || source.col != target.col);
+    if (edgeEnds)
+    {
+        // Walk the ring clockwise from just past the source. The ring cells facing an end (and the
+        // ring corner, if the end is a map corner) are gaps, since the end itself is open; the rest
+        // split into the stretch before the target's gap and the stretch after it.
+        std::vector<Cell> ring;
+        for (int col = -1; col <= cols; col++)
+            ring.push_back({ -1, col });
+        for (int row = 0; row <= rows; row++)
+            ring.push_back({ row, cols });
+        for (int col = cols - 1; col >= -1; col--)
+            ring.push_back({ rows, col });
+        for (int row = rows - 1; row >= 0; row--)
+            ring.push_back({ row, -1 });
+
+        auto faces = [rows, cols](Cell ringCell, Cell end) {
+            int dr = std::abs(ringCell.row - end.row);
+            int dc = std::abs(ringCell.col - end.col);
+            bool corner = (ringCell.row == -1 || ringCell.row == rows) && (ringCell.col == -1 || ringCell.col == cols);
+            return dr + dc == 1 || (corner && dr == 1 && dc == 1);
+        };
+        size_t count = ring.size();
+        size_t first = 0;
+        while (!(faces(ring[first], source) && !faces(ring[(first + 1) % count], source)))
+            first++;
+
+        ringArc.assign((size_t)(rows + 2) * (cols + 2), 0);
+        uint8_t arc = ARC_A;
+        for (size_t step = 1; step < count; step++)
+        {
+            Cell cell = ring[(first + step) % count];
+            if (faces(cell, target))
+                arc = ARC_B;
+            else if (!faces(cell, source))
+                ringArc[DualIndex(cell.row, cell.col)] = arc;
+        }
+    }
+    Recompute();
+}
+
+void Connectivity::SetPassable(Cell cell, bool passable)
+{
+    if (!grid.Contains(cell) || grid.Passable(cell) == passable)
+        return;
+
+    grid.SetPassable(cell, passable);
+    int index = grid.Index(cell);
+    if (index == grid.Index(source) || index == grid.Index(target))
+    {
+        Recompute();
+        return;
+    }
+
+    // Chain filter: off the chain, only blocks hanging off it (or unreachable cells) lose a vertex,
+    // and a newly open cell can only merge blocks if it touches the reachable component. Its tables
+    // stop covering later edits once the dual filter has skipped one it flagged.
+    bool chainChange = chainStale;
+    if (!passable)
+        chainChange = chainChange || onChain[index];
+    for (Cell dir : DIRECTIONS)
+    {
+        Cell adj = { cell.row + dir.row, cell.col + dir.col };
+        if (passable && grid.Contains(adj) && grid.Passable(adj) && order[grid.Index(adj)] != 0)
+            chainChange = true;
+    }
+
+    // Dual filter: only a cluster reaching the border between the ends can be part of a cut.
+    bool dualChange = true;
+    if (edgeEnds)
+    {
+        if (!passable)
+            AddBlocked(cell.row, cell.col);
+        dualChange = clusterArcs[FindCluster(DualIndex(cell.row, cell.col))] != 0;
+    }
+
+    if (chainChange && dualChange)
+        Recompute();
+    else if (chainChange)
+        chainStale = true;
+    else if (!passable)
+        order[index] = 0;
+}
+
+bool Connectivity::WouldDisconnect(Cell cell) const
+{
+    if (!grid.Contains(cell) || !grid.Passable(cell))
+        return !connected;
+    if ((cell.row == source.row && cell.col == source.col) || (cell.row == target.row && cell.col == target.col))
+        return true;
+    return !connected || separator[grid.Index(cell)] != 0;
+}
+
+bool Connectivity::DualBlocked(int row, int col) const
+{
+    Cell cell = { row, col };
+    if (row < -1 || col < -1 || row > grid.Rows() || col > grid.Cols())
+        return false;
+    if (grid.Contains(cell))
+        return !grid.Passable(cell);
+    return ringArc[DualIndex(row, col)] != 0;
+}
+
+int Connectivity::FindCluster(int node)
+{
+    while (clusterParent[node] != node)
+    {
+        clusterParent[node] = clusterParent[clusterParent[node]];
+        node = clusterParent[node];
+    }
+    return node;
+}
+
+void Connectivity::AddBlocked(int row, int col)
+{
+    int node = FindCluster(DualIndex(row, col));
+    for (int dr = -1; dr <= 1; dr++)
+    {
+        for (int dc = -1; dc <= 1; dc++)
+        {
+            if ((dr == 0 && dc == 0) || !DualBlocked(row + dr, col + dc))
+                continue;
+            int other = FindCluster(DualIndex(row + dr, col + dc));
+            if (other == node)
+                continue;
+            if (other < node)
+                std::swap(other, node);
+            clusterParent[other] = node;
+            clusterArcs[node] |= clusterArcs[other];
+        }
+    }
+}
+
+void Connectivity::BuildClusters()
+{
+    size_t nodeCount = (size_t)(grid.Rows() + 2) * (grid.Cols() + 2);
+    clusterParent.resize(nodeCount);
+    for (size_t node = 0; node < nodeCount; node++)
+        clusterParent[node] = (int)node;
+    clusterArcs = ringArc;
+    for (int row = -1; row <= grid.Rows(); row++)
+    {
+        for (int col = -1; col <= grid.Cols(); col++)
+        {
+            if (DualBlocked(row, col))
+                AddBlocked(row, col);
+        }
+    }
+}
+
+void Connectivity::Recompute()
+{
+    recomputes++;
+    chainStale = false;
+    if (edgeEnds)
+        BuildClusters();
+    size_t cellCount = (size_t)grid.Rows() * grid.Cols();
+    order.assign(cellCount, 0);
+    low.assign(cellCount, 0);
+    parent.assign(cellCount, -1);
+    onChain.assign(cellCount, 0);
+    separator.assign(cellCount, 0);
+    connected = false;
+    if (!grid.Contains(source) || !grid.Contains(target) || !grid.Passable(source))
+        return;
+
+    // Iterative Tarjan. When a child's subtree can't reach above its parent, the child's subtree on
+    // the stack plus the parent form one biconnected block. Blocks pop deepest first, so the block
+    // holding the target pops before the one above it: a block is on the chain if it holds the
+    // target or the cut vertex of a chain block popped earlier, and then its own cut vertex is too.
+    int sourceIndex = grid.Index(source);
+    int targetIndex = grid.Index(target);
+    int counter = 1;
+    order[sourceIndex] = low[sourceIndex] = counter++;
+    frames.clear();
+    stack.clear();
+    frames.push_back({ sourceIndex, source, 0 });
+    stack.push_back(sourceIndex);
+    while (!frames.empty())
+    {
+        Frame& frame = frames.back();
+        int index = frame.index;
+        if (frame.nextDirection < (int)DIRECTIONS.size())
+        {
+            Cell dir = DIRECTIONS[frame.nextDirection++];
+            Cell adj = { frame.cell.row + dir.row, frame.cell.col + dir.col };
+            if (!grid.Contains(adj) || !grid.Passable(adj))
+                continue;
+
+            int adjIndex = grid.Index(adj);
+            if (order[adjIndex] == 0)
+            {
+                parent[adjIndex] = index;
+                order[adjIndex] = low[adjIndex] = counter++;
+                stack.push_back(adjIndex);
+                frames.push_back({ adjIndex, adj, 0 });
+            }
+            else if (adjIndex != parent[index])
+            {
+                low[index] = std::min(low[index], order[adjIndex]);
+            }
+            continue;
+        }
+
+        frames.pop_back();
+        if (frames.empty())
+            break;
+        int above = frames.back().index;
+        low[above] = std::min(low[above], low[index]);
+        if (low[index] < order[above])
+            continue;
+
+        block.clear();
+        bool chain = false;
+        int popped;
+        do
+        {
+            popped = stack.back();
+            stack.pop_back();
+            block.push_back(popped);
+            chain = chain || popped == targetIndex || separator[popped];
+        } while (popped != index);
+
+        if (chain)
+        {
+            for (int member : block)
+                onChain[member] = 1;
+            onChain[above] = 1;
+            separator[above] = 1;
+        }
+    }
+
+    connected = grid.Passable(targetIndex) && order[targetIndex] != 0;
+    separator[sourceIndex] = 0;
+    separator[targetIndex] = 0;
+}
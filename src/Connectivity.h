@@ -0,0 +1,77 @@
+#pragma once
+#include "Pathfinder.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Answers "would blocking this cell cut the source off from the target?" in O(1), for hover checks
+// every frame. The cells that do are the cut vertices (articulation points) on the chain of
+// biconnected blocks between source and target, found with one iterative Tarjan DFS from the source.
+//
+// Edits recompute only when they can change the answer: blocking a cell outside that chain of blocks
+// or opening a cell that touches nothing reachable leaves every chain block, and so every answer, as is.
+// When source and target both sit on the map edge a second filter covers open maps, where one big
+// block is the whole chain: by planar duality they are cut apart exactly when the blocked cells,
+// 8-connected, join the two stretches of map border between them. Blocked clusters are kept in a
+// union-find, and an edit to a cluster that touches neither stretch can't change any answer.
+class Connectivity
+{
+public:
+    Connectivity() = default;
+    Connectivity(NavGrid grid, Cell source, Cell target);
+
+    void SetPassable(Cell cell, bool passable);
+
+    bool Connected() const { return connected; }
+
+    // True if blocking the cell would leave no route (or there is none already). Always true for
+    // the source and target themselves, false for cells that are already blocked.
+    bool WouldDisconnect(Cell cell) const;
+
+    const NavGrid& Grid() const { return grid; }
+    size_t Recomputes() const { return recomputes; }
+
+private:
+    void Recompute();
+
+    // Dual nodes cover the grid plus a one-cell ring around it; the ring stands for the border.
+    int DualIndex(int row, int col) const { return (row + 1) * (grid.Cols() + 2) + col + 1; }
+    bool DualBlocked(int row, int col) const;
+    void BuildClusters();
+    void AddBlocked(int row, int col);
+    int FindCluster(int node);
+
+    struct Frame
+    {
+        int index;
+        Cell cell;
+        int nextDirection;
+    };
+
+    NavGrid grid;
+    Cell source{};
+    Cell target{};
+    bool connected = false;
+    size_t recomputes = 0;
+
+    std::vector<int> order;             // DFS discovery order from 1, 0 if not reached from the source.
+    std::vector<int> low;
+    std::vector<int> parent;
+    std::vector<uint8_t> onChain;       // In a biconnected block between source and target.
+    std::vector<uint8_t> separator;     // Cut vertex between source and target.
+
+    // Blocked clusters. Opening a cell doesn't split its cluster until the next recompute rebuilds
+    // them, which only makes the filter recompute more often, never less.
+    enum : uint8_t { ARC_A = 1, ARC_B = 2 };
+    bool edgeEnds = false;
+    bool chainStale = false;            // The dual filter skipped an edit the chain filter wouldn't have.
+    std::vector<uint8_t> ringArc;       // Per dual node: which border stretch a ring node is on, 0 in gaps.
+    std::vector<int> clusterParent;
+    std::vector<uint8_t> clusterArcs;   // Per root: the stretches its cluster touches.
+
+    // DFS scratch.
+    std::vector<Frame> frames;
+    std::vector<int> stack;
+    std::vector<int> block;
+};
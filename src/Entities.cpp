@@ -0,0 +1,65 @@
+#include "Entities.h"
+
+Handle EnemyStore::Insert(const Enemy& enemy)
+{
+    distance.push_back(enemy.distance);
+    segment.push_back(0);
+    x.push_back(enemy.position.x);
+    y.push_back(enemy.position.y);
+    health.push_back(enemy.health);
+    atEnd.push_back(enemy.atEnd);
+    return index.Insert();
+}
+
+void EnemyStore::RemoveAt(size_t i)
+{
+    SwapRemove(distance, i);
+    SwapRemove(segment, i);
+    SwapRemove(x, i);
+    SwapRemove(y, i);
+    SwapRemove(health, i);
+    SwapRemove(atEnd, i);
+    index.RemoveAt(i);
+}
+
+Enemy EnemyStore::Get(size_t i) const
+{
+    Enemy enemy;
+    enemy.distance = distance[i];
+    enemy.position = Position(i);
+    enemy.health = health[i];
+    enemy.atEnd = atEnd[i] != 0;
+    return enemy;
+}
+
+Handle BulletStore::Insert(const Bullet& bullet)
+{
+    x.push_back(bullet.position.x);
+    y.push_back(bullet.position.y);
+    dirX.push_back(bullet.direction.x);
+    dirY.push_back(bullet.direction.y);
+    time.push_back(bullet.time);
+    enabled.push_back(bullet.enabled);
+    return index.Insert();
+}
+
+void BulletStore::RemoveAt(size_t i)
+{
+    SwapRemove(x, i);
+    SwapRemove(y, i);
+    SwapRemove(dirX, i);
+    SwapRemove(dirY, i);
+    SwapRemove(time, i);
+    SwapRemove(enabled, i);
+    index.RemoveAt(i);
+}
+
+Bullet BulletStore::Get(size_t i) const
+{
+    Bullet bullet;
+    bullet.position = Position(i);
+    bullet.direction = { dirX[i], dirY[i] };
+    bullet.time = time[i];
+    bullet.enabled = enabled[i] != 0;
+    return bullet;
+}
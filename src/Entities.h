@@ -0,0 +1,74 @@
+#pragma once
+#include "LineOfSight.h"
+#include "Math.h"
+#include "SlotMap.h"
+
+#include <cstdint>
+#include <vector>
+
+struct Enemy        // [HW3] Struct for the enemies
+{
+    float distance = 0.0f;      // Arc length travelled along the Path.
+
+    Vector2 position{};
+    int health = 10;
+    bool atEnd = false;
+};
+
+struct Turret       // [HW3] Struct for the turrets
+{
+    Vector2 position{};
+    float range = 250.0f;
+    float rateOfFire = 1.0f;
+    int damage = 10;            // -!!- Applying damage to enemy was crashing the program.
+    float currentCDT = 0.0f;
+    Handle target;              // Locked enemy, kept across ticks while it is alive, in range and in sight.
+    VisibilityMask sight;       // Tiles in range it can see into; rebuilt when sight-blocking tiles there change.
+};
+
+struct Bullet
+{
+    Vector2 position{};
+    Vector2 direction{};
+    float time = 0.0f;
+    bool enabled = true;
+};
+
+// Enemies stored as structure-of-arrays so the movement kernel streams only the columns it needs.
+// Index i is the dense index; handles from Insert stay valid across removals.
+struct EnemyStore
+{
+    std::vector<float> distance;    // Arc length along the Path; the authoritative position.
+    std::vector<uint32_t> segment;  // Path segment the enemy is on, used as a search hint.
+    std::vector<float> x;           // Derived from distance each tick for targeting and collision.
+    std::vector<float> y;
+    std::vector<int> health;
+    std::vector<uint8_t> atEnd;
+    SlotIndex index;
+
+    Handle Insert(const Enemy& enemy);
+    void RemoveAt(size_t i);
+
+    Vector2 Position(size_t i) const { return { x[i], y[i] }; }
+    Enemy Get(size_t i) const;
+    size_t size() const { return x.size(); }
+};
+
+// Bullets stored as structure-of-arrays, same layout rules as EnemyStore.
+struct BulletStore
+{
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> dirX;
+    std::vector<float> dirY;
+    std::vector<float> time;
+    std::vector<uint8_t> enabled;
+    SlotIndex index;
+
+    Handle Insert(const Bullet& bullet);
+    void RemoveAt(size_t i);
+
+    Vector2 Position(size_t i) const { return { x[i], y[i] }; }
+    Bullet Get(size_t i) const;
+    size_t size() const { return x.size(); }
+};
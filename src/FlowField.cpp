@@ -0,0 +1,108 @@
+#include "FlowField.h"
+#include "JobSystem.h"
+
+#include <algorithm>
+
+// Frontier cells per chunk. Small levels (every level on the 20x20 map) stay a single chunk.
+static const size_t FRONTIER_GRAIN = 2048;
+static const size_t DIRECTION_ROW_GRAIN = 32;
+
+const int FlowField::UNREACHABLE;
+
+void FlowField::Build(const NavGrid& grid, Cell goal, JobSystem* jobs)
+{
+    rows = grid.Rows();
+    cols = grid.Cols();
+    this->goal = goal;
+    size_t cellCount = (size_t)rows * cols;
+    distance.assign(cellCount, UNREACHABLE);
+    direction.assign(cellCount, -1);
+    if (cellCount > claimedSize)
+    {
+        claimed.reset(new std::atomic<uint8_t>[cellCount]);
+        claimedSize = cellCount;
+    }
+    for (size_t i = 0; i < cellCount; i++)
+        claimed[i].store(0, std::memory_order_relaxed);
+
+    auto parallelFor = [jobs](size_t count, size_t grain, auto&& fn) {
+        if (jobs)
+            jobs->ParallelFor(count, grain, fn);
+        else
+        {
+            for (size_t chunk = 0; chunk * grain < count; chunk++)
+                fn(chunk, chunk * grain, std::min(count, (chunk + 1) * grain));
+        }
+    };
+
+    frontier.clear();
+    if (!grid.Contains(goal) || !grid.Passable(goal))
+        return;
+    int goalIndex = grid.Index(goal);
+    claimed[goalIndex].store(1, std::memory_order_relaxed);
+    distance[goalIndex] = 0;
+    frontier.push_back(goalIndex);
+
+    // Level-synchronous BFS. A cell is claimed by exactly one thread, which is the only writer of its
+    // distance; nothing reads distances until the level is done. Which chunk wins a cell can vary,
+    // so frontier order can too, but a cell's distance is its level either way.
+    for (int level = 1; !frontier.empty(); level++)
+    {
+        size_t chunkCount = JobSystem::ChunkCount(frontier.size(), FRONTIER_GRAIN);
+        if (nextBuffers.size() < chunkCount)
+            nextBuffers.resize(chunkCount);
+        parallelFor(frontier.size(), FRONTIER_GRAIN, [&](size_t chunk, size_t begin, size_t end) {
+            std::vector<int>& next = nextBuffers[chunk];
+            next.clear();
+            for (size_t i = begin; i < end; i++)
+            {
+                Cell cell = grid.CellAt(frontier[i]);
+                for (Cell dir : DIRECTIONS)
+                {
+                    Cell adj = { cell.row + dir.row, cell.col + dir.col };
+                    if (!grid.Contains(adj))
+                        continue;
+                    int index = grid.Index(adj);
+                    if (!grid.Passable(index) || claimed[index].load(std::memory_order_relaxed) ||
+                        claimed[index].exchange(1, std::memory_order_relaxed))
+                        continue;
+                    distance[index] = level;
+                    next.push_back(index);
+                }
+            }
+        });
+
+        frontier.clear();
+        for (size_t chunk = 0; chunk < chunkCount; chunk++)
+            frontier.insert(frontier.end(), nextBuffers[chunk].begin(), nextBuffers[chunk].end());
+    }
+
+    // Directions depend only on the finished distances, so every cell picks its step independently.
+    parallelFor((size_t)rows, DIRECTION_ROW_GRAIN, [&](size_t, size_t begin, size_t end) {
+        for (int row = (int)begin; row < (int)end; row++)
+        {
+            for (int col = 0; col < cols; col++)
+            {
+                int index = row * cols + col;
+                int previous = distance[index] - 1;
+                if (previous < 0)
+                    continue;
+                for (int dir = 0; dir < (int)DIRECTIONS.size(); dir++)
+                {
+                    Cell adj = { row + DIRECTIONS[dir].row, col + DIRECTIONS[dir].col };
+                    if (InBounds(adj, rows, cols) && distance[adj.row * cols + adj.col] == previous)
+                    {
+                        direction[index] = (int8_t)dir;
+                        break;
+                    }
+                }
+            }
+        }
+    });
+}
+
+size_t FlowField::MemoryBytes() const
+{
+    return distance.capacity() * sizeof(int) + direction.capacity() * sizeof(int8_t) + claimedSize +
+        frontier.capacity() * sizeof(int);
+}
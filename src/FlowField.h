@@ -0,0 +1,54 @@
+#pragma once
+#include "Pathfinder.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class JobSystem;
+
+// Steps-to-goal and next-step direction for every cell of a NavGrid, from one breadth-first search
+// outward from the goal. Any number of enemies from any number of spawn points steer by looking up
+// their own cell, so following the field is O(1) per enemy and the search is only redone when the
+// walkable cells change.
+class FlowField
+{
+public:
+    static const int UNREACHABLE = -1;
+
+    // Searches one frontier level at a time. With a JobSystem each level is split across threads;
+    // distances and directions come out identical for any thread count.
+    void Build(const NavGrid& grid, Cell goal, JobSystem* jobs = nullptr);
+
+    int Rows() const { return rows; }
+    int Cols() const { return cols; }
+    Cell Goal() const { return goal; }
+
+    // Steps to the goal, UNREACHABLE if there is no way there (or the cell is blocked).
+    int Distance(Cell cell) const { return distance[cell.row * cols + cell.col]; }
+
+    // The neighbour one step closer to the goal (first in DIRECTIONS order on ties).
+    // Returns the cell itself at the goal and where the goal can't be reached.
+    Cell Next(Cell cell) const
+    {
+        int dir = direction[cell.row * cols + cell.col];
+        return dir < 0 ? cell : Cell{ cell.row + DIRECTIONS[dir].row, cell.col + DIRECTIONS[dir].col };
+    }
+
+    size_t MemoryBytes() const;
+
+private:
+    int rows = 0;
+    int cols = 0;
+    Cell goal{};
+    std::vector<int> distance;
+    std::vector<int8_t> direction;      // Index into DIRECTIONS, -1 for none.
+
+    // Build scratch, kept so rebuilds don't allocate.
+    std::unique_ptr<std::atomic<uint8_t>[]> claimed;    // Set by whichever thread reaches a cell first.
+    size_t claimedSize = 0;
+    std::vector<int> frontier;
+    std::vector<std::vector<int>> nextBuffers;          // Next frontier, one buffer per chunk.
+};
@@ -0,0 +1,153 @@
+#pragma once
+#include "Math.h"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+const float SCREEN_SIZE = 800;
+
+// Tiles across the built-in level. Other maps can be any size; a tile is TILE_SIZE world units either way.
+const int TILE_COUNT = 20;
+const float TILE_SIZE = SCREEN_SIZE / TILE_COUNT;
+
+enum TileType : int
+{
+    GRASS,      // Marks unoccupied space, can be overwritten
+    DIRT,       // Marks the path, cannot be overwritten
+    WAYPOINT,   // Marks where the path turns, cannot be overwritten
+    TURRET,         // [HW3] New tiletype named TURRET, will be called with 3.
+    ROCK,       // Blocks movement, building and turret sight
+    COUNT
+};
+
+struct Cell
+{
+    int row;
+    int col;
+};
+
+constexpr std::array<Cell, 4> DIRECTIONS{ Cell{ -1, 0 }, Cell{ 1, 0 }, Cell{ 0, -1 }, Cell{ 0, 1 } };
+
+inline bool InBounds(Cell cell, int rows, int cols)
+{
+    return cell.col >= 0 && cell.col < cols && cell.row >= 0 && cell.row < rows;
+}
+
+inline Vector2 TileCenter(int row, int col)
+{
+    float x = col * TILE_SIZE + TILE_SIZE * 0.5f;
+    float y = row * TILE_SIZE + TILE_SIZE * 0.5f;
+    return { x, y };
+}
+
+inline Cell TileAt(Vector2 position)
+{
+    return { (int)floorf(position.y / TILE_SIZE), (int)floorf(position.x / TILE_SIZE) };
+}
+
+inline Vector2 TileCorner(int row, int col)
+{
+    float x = col * TILE_SIZE;
+    float y = row * TILE_SIZE;
+    return { x, y };
+}
+
+// Read-only tiles stored elsewhere (a TileGrid, or a map file mapped into memory), same layout as TileGrid.
+class TileView
+{
+public:
+    TileView() = default;
+    TileView(int rows, int cols, const uint8_t* tiles) : rows(rows), cols(cols), tiles(tiles) {}
+
+    int Rows() const { return rows; }
+    int Cols() const { return cols; }
+    bool Contains(Cell cell) const { return InBounds(cell, rows, cols); }
+
+    TileType Get(int row, int col) const { return (TileType)tiles[(size_t)row * cols + col]; }
+    TileType Get(Cell cell) const { return Get(cell.row, cell.col); }
+
+    const uint8_t* Data() const { return tiles; }
+
+private:
+    int rows = 0;
+    int cols = 0;
+    const uint8_t* tiles = nullptr;
+};
+
+// A level's tiles, one byte (a TileType) each, row-major and contiguous.
+// TileGrid<> is sized at runtime. TileGrid<ROWS, COLS> fixes the size at compile time and keeps the
+// tiles inline, for small built-in levels; it converts to TileGrid<> where a runtime grid is wanted.
+template<int ROWS = 0, int COLS = ROWS>
+class TileGrid
+{
+public:
+    TileGrid() { tiles.fill(GRASS); }
+    TileGrid(const uint8_t (&rows)[ROWS][COLS])
+    {
+        for (int row = 0; row < ROWS; row++)
+        {
+            for (int col = 0; col < COLS; col++)
+                tiles[(size_t)row * COLS + col] = rows[row][col];
+        }
+    }
+
+    constexpr int Rows() const { return ROWS; }
+    constexpr int Cols() const { return COLS; }
+    bool Contains(Cell cell) const { return InBounds(cell, ROWS, COLS); }
+
+    TileType Get(int row, int col) const { return (TileType)tiles[(size_t)row * COLS + col]; }
+    TileType Get(Cell cell) const { return Get(cell.row, cell.col); }
+    void Set(Cell cell, TileType type) { tiles[(size_t)cell.row * COLS + cell.col] = (uint8_t)type; }
+
+    const uint8_t* Data() const { return tiles.data(); }
+    operator TileView() const { return { ROWS, COLS, tiles.data() }; }
+
+private:
+    std::array<uint8_t, ROWS * COLS> tiles;
+};
+
+template<>
+class TileGrid<0, 0>
+{
+public:
+    TileGrid() = default;
+    TileGrid(int rows, int cols, TileType fill = GRASS)
+        : rows(rows), cols(cols), tiles((size_t)rows * cols, (uint8_t)fill)
+    {
+    }
+    TileGrid(int rows, int cols, const uint8_t* data)
+        : rows(rows), cols(cols), tiles(data, data + (size_t)rows * cols)
+    {
+    }
+    template<int ROWS, int COLS>
+    TileGrid(const TileGrid<ROWS, COLS>& fixed)
+        : TileGrid(ROWS, COLS, fixed.Data())
+    {
+    }
+    TileGrid(TileView view)
+        : TileGrid(view.Rows(), view.Cols(), view.Data())
+    {
+    }
+
+    int Rows() const { return rows; }
+    int Cols() const { return cols; }
+    bool Contains(Cell cell) const { return InBounds(cell, rows, cols); }
+
+    TileType Get(int row, int col) const { return (TileType)tiles[(size_t)row * cols + col]; }
+    TileType Get(Cell cell) const { return Get(cell.row, cell.col); }
+    void Set(Cell cell, TileType type) { tiles[(size_t)cell.row * cols + cell.col] = (uint8_t)type; }
+
+    const uint8_t* Data() const { return tiles.data(); }
+    operator TileView() const { return { rows, cols, tiles.data() }; }
+
+private:
+    int rows = 0;
+    int cols = 0;
+    std::vector<uint8_t> tiles;
+};
+
+// The built-in level layout, the cell enemies spawn on and the cell they walk to.
+extern const TileGrid<TILE_COUNT> LEVEL_TILES;
+const Cell LEVEL_SPAWN{ 0, 12 };
+const Cell LEVEL_GOAL{ 19, 9 };
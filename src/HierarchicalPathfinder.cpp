@@ -0,0 +1,344 @@
+#include "HierarchicalPathfinder.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+
+static const int INFINITE_COST = 0x3fffffff;
+
+static int Manhattan(Cell a, Cell b)
+{
+    return abs(a.row - b.row) + abs(a.col - b.col);
+}
+
+static bool SameCell(Cell a, Cell b)
+{
+    return a.row == b.row && a.col == b.col;
+}
+
+HierarchicalPathfinder::HierarchicalPathfinder(NavGrid grid, int clusterSize)
+    : grid(std::move(grid)), clusterSize(std::max(clusterSize, 1))
+{
+    clustersAcross = (this->grid.Cols() + this->clusterSize - 1) / this->clusterSize;
+    int clustersDown = (this->grid.Rows() + this->clusterSize - 1) / this->clusterSize;
+    clusters.resize((size_t)clustersAcross * clustersDown);
+    isDirty.assign(clusters.size(), 0);
+    for (int cy = 0; cy < clustersDown; cy++)
+    {
+        for (int cx = 0; cx < clustersAcross; cx++)
+        {
+            Cluster& cluster = clusters[cy * clustersAcross + cx];
+            cluster.row = cy * this->clusterSize;
+            cluster.col = cx * this->clusterSize;
+            cluster.rows = std::min(this->clusterSize, this->grid.Rows() - cluster.row);
+            cluster.cols = std::min(this->clusterSize, this->grid.Cols() - cluster.col);
+            MarkDirty(cy * clustersAcross + cx);
+        }
+    }
+    Rebuild();
+}
+
+void HierarchicalPathfinder::MarkDirty(int cluster)
+{
+    if (!isDirty[cluster])
+    {
+        isDirty[cluster] = 1;
+        dirty.push_back(cluster);
+    }
+}
+
+void HierarchicalPathfinder::SetPassable(Cell cell, bool passable)
+{
+    if (!grid.Contains(cell) || grid.Passable(cell) == passable)
+        return;
+
+    // The cell's own paths change, and if it sits on a border so do the neighbour's entrances.
+    grid.SetPassable(cell, passable);
+    int home = ClusterOf(cell);
+    MarkDirty(home);
+    for (Cell dir : DIRECTIONS)
+    {
+        Cell adj = { cell.row + dir.row, cell.col + dir.col };
+        if (grid.Contains(adj) && ClusterOf(adj) != home)
+            MarkDirty(ClusterOf(adj));
+    }
+}
+
+size_t HierarchicalPathfinder::Rebuild()
+{
+    size_t rebuilt = dirty.size();
+    if (rebuilt == 0)
+        return 0;
+
+    for (int cluster : dirty)
+    {
+        BuildCluster(clusters[cluster]);
+        isDirty[cluster] = 0;
+    }
+    dirty.clear();
+
+    nodeBase.resize(clusters.size());
+    nodeCount = 0;
+    for (size_t c = 0; c < clusters.size(); c++)
+    {
+        nodeBase[c] = (int)nodeCount;
+        nodeCount += clusters[c].nodes.size();
+    }
+    nodeCluster.resize(nodeCount);
+    for (size_t c = 0; c < clusters.size(); c++)
+        std::fill(nodeCluster.begin() + nodeBase[c], nodeCluster.begin() + nodeBase[c] + clusters[c].nodes.size(), (int)c);
+    return rebuilt;
+}
+
+// Walks `length` cell pairs along one border and adds an entrance at the middle of every run where
+// both sides are open. Both clusters walk the shared border in the same order, so they agree on it.
+void HierarchicalPathfinder::AddEntrances(Cluster& cluster, Cell inside, Cell outside, Cell step, int length)
+{
+    int runStart = -1;
+    for (int t = 0; t <= length; t++)
+    {
+        Cell in = { inside.row + step.row * t, inside.col + step.col * t };
+        Cell out = { outside.row + step.row * t, outside.col + step.col * t };
+        bool open = t < length && grid.Contains(out) && grid.Passable(in) && grid.Passable(out);
+        if (open && runStart < 0)
+            runStart = t;
+        if (open || runStart < 0)
+            continue;
+
+        int middle = (runStart + t - 1) / 2;
+        Cell node = { inside.row + step.row * middle, inside.col + step.col * middle };
+        int index = NodeIndex(cluster, node);
+        if (index < 0)
+        {
+            index = (int)cluster.nodes.size();
+            cluster.nodes.push_back(node);
+        }
+        cluster.exits.push_back({ outside.row + step.row * middle, outside.col + step.col * middle });
+        cluster.exitNode.push_back(index);
+        runStart = -1;
+    }
+}
+
+void HierarchicalPathfinder::BuildCluster(Cluster& cluster)
+{
+    cluster.nodes.clear();
+    cluster.exits.clear();
+    cluster.exitNode.clear();
+
+    int top = cluster.row;
+    int left = cluster.col;
+    int bottom = cluster.row + cluster.rows - 1;
+    int right = cluster.col + cluster.cols - 1;
+    AddEntrances(cluster, { top, left }, { top - 1, left }, { 0, 1 }, cluster.cols);
+    AddEntrances(cluster, { bottom, left }, { bottom + 1, left }, { 0, 1 }, cluster.cols);
+    AddEntrances(cluster, { top, left }, { top, left - 1 }, { 1, 0 }, cluster.rows);
+    AddEntrances(cluster, { top, right }, { top, right + 1 }, { 1, 0 }, cluster.rows);
+
+    size_t count = cluster.nodes.size();
+    cluster.costs.assign(count * count, INFINITE_COST);
+    for (size_t i = 0; i < count; i++)
+    {
+        LocalSearch(cluster, cluster.nodes[i]);
+        for (size_t j = 0; j < count; j++)
+            cluster.costs[i * count + j] = LocalDistance(cluster, cluster.nodes[j]);
+    }
+}
+
+int HierarchicalPathfinder::NodeIndex(const Cluster& cluster, Cell cell) const
+{
+    for (size_t i = 0; i < cluster.nodes.size(); i++)
+    {
+        if (SameCell(cluster.nodes[i], cell))
+            return (int)i;
+    }
+    return -1;
+}
+
+void HierarchicalPathfinder::LocalSearch(const Cluster& cluster, Cell from)
+{
+    localDistance.assign((size_t)cluster.rows * cluster.cols, INFINITE_COST);
+    localQueue.clear();
+    if (!grid.Passable(from))
+        return;
+
+    auto local = [&cluster](Cell cell) {
+        return (cell.row - cluster.row) * cluster.cols + (cell.col - cluster.col);
+    };
+    localDistance[local(from)] = 0;
+    localQueue.push_back(local(from));
+    for (size_t head = 0; head < localQueue.size(); head++)
+    {
+        int index = localQueue[head];
+        Cell cell = { cluster.row + index / cluster.cols, cluster.col + index % cluster.cols };
+        for (Cell dir : DIRECTIONS)
+        {
+            Cell adj = { cell.row + dir.row, cell.col + dir.col };
+            if (adj.row < cluster.row || adj.row >= cluster.row + cluster.rows ||
+                adj.col < cluster.col || adj.col >= cluster.col + cluster.cols || !grid.Passable(adj))
+                continue;
+            int adjIndex = local(adj);
+            if (localDistance[adjIndex] != INFINITE_COST)
+                continue;
+            localDistance[adjIndex] = localDistance[index] + 1;
+            localQueue.push_back(adjIndex);
+        }
+    }
+}
+
+int HierarchicalPathfinder::LocalDistance(const Cluster& cluster, Cell cell) const
+{
+    return localDistance[(cell.row - cluster.row) * cluster.cols + (cell.col - cluster.col)];
+}
+
+// -- QUERY ---------------------------------
+bool HierarchicalPathfinder::FindAbstractPath(Cell start, Cell goal, std::vector<Cell>& abstract)
+{
+    struct Entry
+    {
+        uint64_t key;       // f in the high half, h in the low half.
+        int node;
+    };
+    auto after = [](const Entry& a, const Entry& b) {
+        return a.key > b.key;
+    };
+
+    abstract.clear();
+    Rebuild();
+    if (!grid.Contains(start) || !grid.Contains(goal) || !grid.Passable(start) || !grid.Passable(goal))
+        return false;
+
+    // Temporary edges from the start into its cluster's entrances, and from the goal's cluster's
+    // entrances to the goal (plus the direct one if both are in the same cluster).
+    int startCluster = ClusterOf(start);
+    int goalCluster = ClusterOf(goal);
+    const Cluster& first = clusters[startCluster];
+    const Cluster& last = clusters[goalCluster];
+    LocalSearch(first, start);
+    startCosts.resize(first.nodes.size());
+    for (size_t i = 0; i < first.nodes.size(); i++)
+        startCosts[i] = LocalDistance(first, first.nodes[i]);
+    int direct = startCluster == goalCluster ? LocalDistance(first, goal) : INFINITE_COST;
+    LocalSearch(last, goal);
+    goalCosts.resize(last.nodes.size());
+    for (size_t i = 0; i < last.nodes.size(); i++)
+        goalCosts[i] = LocalDistance(last, last.nodes[i]);
+
+    int startNode = (int)nodeCount;
+    int goalNode = (int)nodeCount + 1;
+    auto cellOf = [&](int node) {
+        if (node == startNode)
+            return start;
+        if (node == goalNode)
+            return goal;
+        return clusters[nodeCluster[node]].nodes[node - nodeBase[nodeCluster[node]]];
+    };
+
+    cost.assign(nodeCount + 2, INFINITE_COST);
+    parent.assign(nodeCount + 2, -1);
+    std::vector<Entry> open;
+    auto relax = [&](int from, int to, int step) {
+        if (step >= INFINITE_COST || cost[from] + step >= cost[to])
+            return;
+        cost[to] = cost[from] + step;
+        parent[to] = from;
+        uint64_t h = (uint64_t)Manhattan(cellOf(to), goal);
+        open.push_back({ ((cost[to] + h) << 32) | h, to });
+        std::push_heap(open.begin(), open.end(), after);
+    };
+
+    cost[startNode] = 0;
+    for (size_t i = 0; i < first.nodes.size(); i++)
+        relax(startNode, nodeBase[startCluster] + (int)i, startCosts[i]);
+    relax(startNode, goalNode, direct);
+
+    while (!open.empty())
+    {
+        std::pop_heap(open.begin(), open.end(), after);
+        Entry entry = open.back();
+        open.pop_back();
+        int node = entry.node;
+        if (node == goalNode)
+            break;
+        if (entry.key >> 32 != (uint64_t)cost[node] + Manhattan(cellOf(node), goal))
+            continue;   // Superseded by a cheaper entry.
+
+        int c = nodeCluster[node];
+        const Cluster& cluster = clusters[c];
+        int local = node - nodeBase[c];
+        size_t count = cluster.nodes.size();
+        for (size_t j = 0; j < count; j++)
+            relax(node, nodeBase[c] + (int)j, cluster.costs[local * count + j]);
+        for (size_t k = 0; k < cluster.exits.size(); k++)
+        {
+            if (cluster.exitNode[k] != local)
+                continue;
+            int across = ClusterOf(cluster.exits[k]);
+            int index = NodeIndex(clusters[across], cluster.exits[k]);
+            if (index >= 0)
+                relax(node, nodeBase[across] + index, 1);
+        }
+        if (c == goalCluster)
+            relax(node, goalNode, goalCosts[local]);
+    }
+
+    if (cost[goalNode] >= INFINITE_COST)
+        return false;
+    for (int node = goalNode; node != -1; node = parent[node])
+        abstract.push_back(cellOf(node));
+    std::reverse(abstract.begin(), abstract.end());
+    return true;
+}
+
+void HierarchicalPathfinder::Refine(const std::vector<Cell>& abstract, std::vector<Cell>& route)
+{
+    route.clear();
+    if (abstract.empty())
+        return;
+
+    route.push_back(abstract[0]);
+    for (size_t i = 1; i < abstract.size(); i++)
+    {
+        Cell from = abstract[i - 1];
+        Cell to = abstract[i];
+        if (SameCell(from, to))
+            continue;
+        if (ClusterOf(from) != ClusterOf(to))
+        {
+            route.push_back(to);    // Border crossing: the two cells are neighbours.
+            continue;
+        }
+
+        // Search back from the leg's end, then walk downhill from its start.
+        const Cluster& cluster = clusters[ClusterOf(from)];
+        LocalSearch(cluster, to);
+        Cell cell = from;
+        while (!SameCell(cell, to))
+        {
+            int distance = LocalDistance(cluster, cell);
+            for (Cell dir : DIRECTIONS)
+            {
+                Cell adj = { cell.row + dir.row, cell.col + dir.col };
+                if (adj.row >= cluster.row && adj.row < cluster.row + cluster.rows &&
+                    adj.col >= cluster.col && adj.col < cluster.col + cluster.cols &&
+                    LocalDistance(cluster, adj) == distance - 1)
+                {
+                    cell = adj;
+                    break;
+                }
+            }
+            route.push_back(cell);
+        }
+    }
+}
+
+bool HierarchicalPathfinder::FindPath(Cell start, Cell goal, std::vector<Cell>& route)
+{
+    std::vector<Cell> abstract;
+    if (!FindAbstractPath(start, goal, abstract))
+    {
+        route.clear();
+        return false;
+    }
+    Refine(abstract, route);
+    return true;
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include "Pathfinder.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// HPA* (Botea, Mueller & Schaeffer 2004) over a NavGrid for maps too large to search flat.
+// The grid is cut into square clusters. Every run of open cells along a border between two
+// clusters becomes one entrance, and the step counts between a cluster's entrances are cached.
+// A query searches that small graph and only expands the result to tiles on request.
+// The result is near-optimal: it is constrained to pass through the entrance cells.
+//
+// Edits mark the edited cell's cluster (and the neighbour it borders, if any) dirty; the next query
+// rebuilds just those clusters.
+class HierarchicalPathfinder
+{
+public:
+    explicit HierarchicalPathfinder(NavGrid grid, int clusterSize = 16);
+
+    void SetPassable(Cell cell, bool passable);
+
+    // Rebuilds the dirty clusters. Queries call it automatically; returns the number rebuilt.
+    size_t Rebuild();
+
+    // Coarse route: start, each entrance cell crossed, goal. Consecutive cells always share a
+    // cluster or sit on either side of a border. Returns false if the goal can't be reached.
+    bool FindAbstractPath(Cell start, Cell goal, std::vector<Cell>& abstract);
+
+    // Expands a coarse route into every tile from start to goal, one cluster-local search per leg.
+    void Refine(const std::vector<Cell>& abstract, std::vector<Cell>& route);
+
+    // FindAbstractPath followed by Refine.
+    bool FindPath(Cell start, Cell goal, std::vector<Cell>& route);
+
+    const NavGrid& Grid() const { return grid; }
+    int ClusterSize() const { return clusterSize; }
+    size_t ClusterCount() const { return clusters.size(); }
+    size_t NodeCount() const { return nodeCount; }
+
+private:
+    struct Cluster
+    {
+        int row;
+        int col;
+        int rows;
+        int cols;
+        std::vector<Cell> nodes;        // Distinct entrance cells on this cluster's side of its borders.
+        std::vector<Cell> exits;        // Cell across the border from nodes[exitNode[k]].
+        std::vector<int> exitNode;
+        std::vector<int> costs;         // nodes x nodes step counts inside the cluster.
+    };
+
+    int ClusterOf(Cell cell) const { return (cell.row / clusterSize) * clustersAcross + cell.col / clusterSize; }
+    void MarkDirty(int cluster);
+    void BuildCluster(Cluster& cluster);
+    void AddEntrances(Cluster& cluster, Cell inside, Cell outside, Cell step, int length);
+    int NodeIndex(const Cluster& cluster, Cell cell) const;
+
+    // Breadth-first search from `from` that stays inside the cluster; fills localDistance.
+    void LocalSearch(const Cluster& cluster, Cell from);
+    int LocalDistance(const Cluster& cluster, Cell cell) const;
+
+    NavGrid grid;
+    int clusterSize;
+    int clustersAcross;
+    std::vector<Cluster> clusters;
+    std::vector<int> dirty;
+    std::vector<uint8_t> isDirty;
+    std::vector<int> nodeBase;          // First global node id of each cluster.
+    std::vector<int> nodeCluster;       // Cluster of each global node id.
+    size_t nodeCount = 0;
+
+    // Query scratch.
+    std::vector<int> localDistance;
+    std::vector<int> localQueue;
+    std::vector<int> startCosts;
+    std::vector<int> goalCosts;
+    std::vector<int> cost;
+    std::vector<int> parent;
+};
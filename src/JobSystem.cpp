@@ -0,0 +1,105 @@
+#include "JobSystem.h"
+
+#include <algorithm>
+
+JobSystem::JobSystem(unsigned threadCount)
+{
+    if (threadCount == 0)
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+    for (unsigned i = 0; i < threadCount; i++)
+        queues.push_back(std::make_unique<Queue>());
+    for (unsigned i = 1; i < threadCount; i++)
+        workers.emplace_back(&JobSystem::WorkerLoop, this, i);
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& worker : workers)
+        worker.join();
+}
+
+void JobSystem::Run(void (*invoke)(void*, size_t), void* context, size_t chunkCount)
+{
+    // Nothing to share: skip the queues entirely.
+    if (chunkCount == 1 || workers.empty())
+    {
+        for (size_t chunk = 0; chunk < chunkCount; chunk++)
+            invoke(context, chunk);
+        return;
+    }
+
+    // Deal chunks round-robin so every thread starts with local work; stealing evens out the rest.
+    std::atomic<size_t> remaining{ chunkCount };
+    for (size_t chunk = 0; chunk < chunkCount; chunk++)
+    {
+        Queue& queue = *queues[chunk % queues.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back({ invoke, context, chunk, &remaining });
+    }
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        queued += chunkCount;
+    }
+    wake.notify_all();
+
+    while (remaining.load(std::memory_order_acquire) > 0)
+    {
+        if (!TryRunOne(0))
+            std::this_thread::yield();
+    }
+}
+
+bool JobSystem::TryRunOne(unsigned self)
+{
+    Task task{};
+    bool found = false;
+    for (size_t offset = 0; offset < queues.size() && !found; offset++)
+    {
+        Queue& queue = *queues[(self + offset) % queues.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty())
+            continue;
+
+        // Own queue: newest first for locality. Someone else's: steal the oldest.
+        if (offset == 0)
+        {
+            task = queue.tasks.back();
+            queue.tasks.pop_back();
+        }
+        else
+        {
+            task = queue.tasks.front();
+            queue.tasks.pop_front();
+        }
+        found = true;
+    }
+    if (!found)
+        return false;
+
+    queued--;
+    task.invoke(task.context, task.chunk);
+    task.remaining->fetch_sub(1, std::memory_order_release);
+    return true;
+}
+
+void JobSystem::WorkerLoop(unsigned self)
+{
+    while (true)
+    {
+        if (TryRunOne(self))
+            continue;
+
+        std::unique_lock<std::mutex> lock(wakeMutex);
+        wake.wait(lock, [this]() {
+            return stopping || queued > 0;
+        });
+        if (stopping)
+            return;
+    }
+}
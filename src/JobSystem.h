@@ -0,0 +1,86 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Work-stealing thread pool. Each thread owns a task queue, pops from its own back and steals
+// from the front of the others'. The thread calling ParallelFor runs tasks too, as thread 0.
+//
+// Chunking depends only on the item count and grain, never on the thread count, so callers that
+// write per-chunk results and merge them in chunk order get bit-identical output on any machine.
+class JobSystem
+{
+public:
+    // 0 uses every hardware thread. 1 runs everything inline on the caller with no workers.
+    explicit JobSystem(unsigned threadCount = 0);
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    unsigned ThreadCount() const { return (unsigned)queues.size(); }
+
+    static size_t ChunkCount(size_t count, size_t grain) { return (count + grain - 1) / grain; }
+
+    // Calls fn(chunk, begin, end) for every chunk [chunk * grain, min(count, (chunk + 1) * grain))
+    // and returns once all of them have finished. Chunks may run in any order and on any thread.
+    template<typename Fn>
+    void ParallelFor(size_t count, size_t grain, Fn&& fn);
+
+private:
+    struct Task
+    {
+        void (*invoke)(void* context, size_t chunk);
+        void* context;
+        size_t chunk;
+        std::atomic<size_t>* remaining;
+    };
+
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void Run(void (*invoke)(void*, size_t), void* context, size_t chunkCount);
+    bool TryRunOne(unsigned self);
+    void WorkerLoop(unsigned self);
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+    std::mutex wakeMutex;
+    std::condition_variable wake;
+    std::atomic<size_t> queued{ 0 };
+    bool stopping = false;
+};
+
+template<typename Fn>
+void JobSystem::ParallelFor(size_t count, size_t grain, Fn&& fn)
+{
+    if (count == 0)
+        return;
+    if (grain == 0)
+        grain = 1;
+
+    struct Context
+    {
+        typename std::remove_reference<Fn>::type* fn;
+        size_t count;
+        size_t grain;
+    };
+    Context context{ &fn, count, grain };
+
+    auto invoke = [](void* raw, size_t chunk) {
+        Context& c = *static_cast<Context*>(raw);
+        size_t begin = chunk * c.grain;
+        size_t end = begin + c.grain < c.count ? begin + c.grain : c.count;
+        (*c.fn)(chunk, begin, end);
+    };
+    Run(invoke, &context, ChunkCount(count, grain));
+}
@@ -0,0 +1,651 @@
+#include "Kernels.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define KERNELS_AVX
+#elif defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define KERNELS_SSE2
+#elif defined(_M_ARM64) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#define KERNELS_NEON
+#endif
+
+void MoveKernel(float* x, float* y, const float* vx, const float* vy, float scale, size_t count)
+{
+    size_t i = 0;
+#if defined(KERNELS_AVX)
+    __m256 s = _mm256_set1_ps(scale);
+    for (; i + 8 <= count; i += 8)
+    {
+        _mm256_storeu_ps(x + i, _mm256_add_ps(_mm256_loadu_ps(x + i), _mm256_mul_ps(_mm256_loadu_ps(vx + i), s)));
+        _mm256_storeu_ps(y + i, _mm256_add_ps(_mm256_loadu_ps(y + i), _mm256_mul_ps(_mm256_loadu_ps(vy + i), s)));
+    }
+#elif defined(KERNELS_SSE2)
+    __m128 s = _mm_set1_ps(scale);
+    for (; i + 4 <= count; i += 4)
+    {
+        _mm_storeu_ps(x + i, _mm_add_ps(_mm_loadu_ps(x + i), _mm_mul_ps(_mm_loadu_ps(vx + i), s)));
+        _mm_storeu_ps(y + i, _mm_add_ps(_mm_loadu_ps(y + i), _mm_mul_ps(_mm_loadu_ps(vy + i), s)));
+    }
+#elif defined(KERNELS_NEON)
+    float32x4_t s = vdupq_n_f32(scale);
+    for (; i + 4 <= count; i += 4)
+    {
+        vst1q_f32(x + i, vmlaq_f32(vld1q_f32(x + i), vld1q_f32(vx + i), s));
+        vst1q_f32(y + i, vmlaq_f32(vld1q_f32(y + i), vld1q_f32(vy + i), s));
+    }
+#endif
+    for (; i < count; i++)
+    {
+        x[i] += vx[i] * scale;
+        y[i] += vy[i] * scale;
+    }
+}
+
+void AddKernel(float* values, float add, size_t count)
+{
+    size_t i = 0;
+#if defined(KERNELS_AVX)
+    __m256 a = _mm256_set1_ps(add);
+    for (; i + 8 <= count; i += 8)
+        _mm256_storeu_ps(values + i, _mm256_add_ps(_mm256_loadu_ps(values + i), a));
+#elif defined(KERNELS_SSE2)
+    __m128 a = _mm_set1_ps(add);
+    for (; i + 4 <= count; i += 4)
+        _mm_storeu_ps(values + i, _mm_add_ps(_mm_loadu_ps(values + i), a));
+#elif defined(KERNELS_NEON)
+    float32x4_t a = vdupq_n_f32(add);
+    for (; i + 4 <= count; i += 4)
+        vst1q_f32(values + i, vaddq_f32(vld1q_f32(values + i), a));
+#endif
+    for (; i < count; i++)
+        values[i] += add;
+}
+
+void ScaleKernel(float* values, float scale, size_t count)
+{
+    size_t i = 0;
+#if defined(KERNELS_AVX)
+    __m256 s = _mm256_set1_ps(scale);
+    for (; i + 8 <= count; i += 8)
+        _mm256_storeu_ps(values + i, _mm256_mul_ps(_mm256_loadu_ps(values + i), s));
+#elif defined(KERNELS_SSE2)
+    __m128 s = _mm_set1_ps(scale);
+    for (; i + 4 <= count; i += 4)
+        _mm_storeu_ps(values + i, _mm_mul_ps(_mm_loadu_ps(values + i), s));
+#elif defined(KERNELS_NEON)
+    float32x4_t s = vdupq_n_f32(scale);
+    for (; i + 4 <= count; i += 4)
+        vst1q_f32(values + i, vmulq_f32(vld1q_f32(values + i), s));
+#endif
+    for (; i < count; i++)
+        values[i] *= scale;
+}
+
+void NormalizeKernel(float* x, float* y, size_t count)
+{
+    // A true divide and square root rather than the approximate reciprocals, so every lane rounds the
+    // way sqrtf and 1.0f / length do. Lanes whose length isn't above zero (zero, underflow, NaN) are
+    // masked to zero like the scalar branch.
+    size_t i = 0;
+#if defined(KERNELS_AVX)
+    __m256 one = _mm256_set1_ps(1.0f);
+    __m256 zero = _mm256_setzero_ps();
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256 vx = _mm256_loadu_ps(x + i);
+        __m256 vy = _mm256_loadu_ps(y + i);
+        __m256 length = _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(vx, vx), _mm256_mul_ps(vy, vy)));
+        __m256 inverse = _mm256_and_ps(_mm256_div_ps(one, length), _mm256_cmp_ps(length, zero, _CMP_GT_OQ));
+        _mm256_storeu_ps(x + i, _mm256_mul_ps(vx, inverse));
+        _mm256_storeu_ps(y + i, _mm256_mul_ps(vy, inverse));
+    }
+#elif defined(KERNELS_SSE2)
+    __m128 one = _mm_set1_ps(1.0f);
+    __m128 zero = _mm_setzero_ps();
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 vx = _mm_loadu_ps(x + i);
+        __m128 vy = _mm_loadu_ps(y + i);
+        __m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy)));
+        __m128 inverse = _mm_and_ps(_mm_div_ps(one, length), _mm_cmpgt_ps(length, zero));
+        _mm_storeu_ps(x + i, _mm_mul_ps(vx, inverse));
+        _mm_storeu_ps(y + i, _mm_mul_ps(vy, inverse));
+    }
+#elif defined(KERNELS_NEON)
+    float32x4_t one = vdupq_n_f32(1.0f);
+    float32x4_t zero = vdupq_n_f32(0.0f);
+    for (; i + 4 <= count; i += 4)
+    {
+        float32x4_t vx = vld1q_f32(x + i);
+        float32x4_t vy = vld1q_f32(y + i);
+        float32x4_t length = vsqrtq_f32(vaddq_f32(vmulq_f32(vx, vx), vmulq_f32(vy, vy)));
+        uint32x4_t positive = vcgtq_f32(length, zero);
+        float32x4_t inverse = vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(vdivq_f32(one, length)), positive));
+        vst1q_f32(x + i, vmulq_f32(vx, inverse));
+        vst1q_f32(y + i, vmulq_f32(vy, inverse));
+    }
+#endif
+    for (; i < count; i++)
+    {
+        Vector2 v = Normalize(Vector2{ x[i], y[i] });
+        x[i] = v.x;
+        y[i] = v.y;
+    }
+}
+
+// Shared body of DistanceSqrKernel and DistanceKernel; the square root is a compile-time choice.
+template<bool ROOT>
+static void DistanceLoop(Vector2 point, const float* x, const float* y, float* out, size_t count)
+{
+    size_t i = 0;
+#if defined(KERNELS_AVX)
+    __m256 px = _mm256_set1_ps(point.x);
+    __m256 py = _mm256_set1_ps(point.y);
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256 dx = _mm256_sub_ps(px, _mm256_loadu_ps(x + i));
+        __m256 dy = _mm256_sub_ps(py, _mm256_loadu_ps(y + i));
+        __m256 squared = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+        _mm256_storeu_ps(out + i, ROOT ? _mm256_sqrt_ps(squared) : squared);
+    }
+#elif defined(KERNELS_SSE2)
+    __m128 px = _mm_set1_ps(point.x);
+    __m128 py = _mm_set1_ps(point.y);
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 dx = _mm_sub_ps(px, _mm_loadu_ps(x + i));
+        __m128 dy = _mm_sub_ps(py, _mm_loadu_ps(y + i));
+        __m128 squared = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+        _mm_storeu_ps(out + i, ROOT ? _mm_sqrt_ps(squared) : squared);
+    }
+#elif defined(KERNELS_NEON)
+    float32x4_t px = vdupq_n_f32(point.x);
+    float32x4_t py = vdupq_n_f32(point.y);
+    for (; i + 4 <= count; i += 4)
+    {
+        float32x4_t dx = vsubq_f32(px, vld1q_f32(x + i));
+        float32x4_t dy = vsubq_f32(py, vld1q_f32(y + i));
+        float32x4_t squared = vaddq_f32(vmulq_f32(dx, dx), vmulq_f32(dy, dy));
+        vst1q_f32(out + i, ROOT ? vsqrtq_f32(squared) : squared);
+    }
+#endif
+    for (; i < count; i++)
+        out[i] = ROOT ? Distance(point, Vector2{ x[i], y[i] }) : DistanceSqr(point, Vector2{ x[i], y[i] });
+}
+
+void DistanceSqrKernel(Vector2 point, const float* x, const float* y, float* out, size_t count)
+{
+    DistanceLoop<false>(point, x, y, out, count);
+}
+
+void DistanceKernel(Vector2 point, const float* x, const float* y, float* out, size_t count)
+{
+    DistanceLoop<true>(point, x, y, out, count);
+}
+
+void LerpKernel(float* x, float* y, const float* toX, const float* toY, float amount, size_t count)
+{
+    size_t i = 0;
+#if defined(KERNELS_AVX)
+    __m256 a = _mm256_set1_ps(amount);
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256 vx = _mm256_loadu_ps(x + i);
+        __m256 vy = _mm256_loadu_ps(y + i);
+        _mm256_storeu_ps(x + i, _mm256_add_ps(vx, _mm256_mul_ps(a, _mm256_sub_ps(_mm256_loadu_ps(toX + i), vx))));
+        _mm256_storeu_ps(y + i, _mm256_add_ps(vy, _mm256_mul_ps(a, _mm256_sub_ps(_mm256_loadu_ps(toY + i), vy))));
+    }
+#elif defined(KERNELS_SSE2)
+    __m128 a = _mm_set1_ps(amount);
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 vx = _mm_loadu_ps(x + i);
+        __m128 vy = _mm_loadu_ps(y + i);
+        _mm_storeu_ps(x + i, _mm_add_ps(vx, _mm_mul_ps(a, _mm_sub_ps(_mm_loadu_ps(toX + i), vx))));
+        _mm_storeu_ps(y + i, _mm_add_ps(vy, _mm_mul_ps(a, _mm_sub_ps(_mm_loadu_ps(toY + i), vy))));
+    }
+#elif defined(KERNELS_NEON)
+    float32x4_t a = vdupq_n_f32(amount);
+    for (; i + 4 <= count; i += 4)
+    {
+        float32x4_t vx = vld1q_f32(x + i);
+        float32x4_t vy = vld1q_f32(y + i);
+        vst1q_f32(x + i, vaddq_f32(vx, vmulq_f32(a, vsubq_f32(vld1q_f32(toX + i), vx))));
+        vst1q_f32(y + i, vaddq_f32(vy, vmulq_f32(a, vsubq_f32(vld1q_f32(toY + i), vy))));
+    }
+#endif
+    for (; i < count; i++)
+    {
+        Vector2 v = Lerp(Vector2{ x[i], y[i] }, Vector2{ toX[i], toY[i] }, amount);
+        x[i] = v.x;
+        y[i] = v.y;
+    }
+}
+
+void TransformKernel(float* x, float* y, const Matrix& mat, size_t count)
+{
+    // Multiply's z term is mat.m8 * 0, which adds nothing; the rest is the same sums in the same order.
+    size_t i = 0;
+#if defined(KERNELS_AVX)
+    __m256 m0 = _mm256_set1_ps(mat.m0), m4 = _mm256_set1_ps(mat.m4), m12 = _mm256_set1_ps(mat.m12);
+    __m256 m1 = _mm256_set1_ps(mat.m1), m5 = _mm256_set1_ps(mat.m5), m13 = _mm256_set1_ps(mat.m13);
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256 vx = _mm256_loadu_ps(x + i);
+        __m256 vy = _mm256_loadu_ps(y + i);
+        _mm256_storeu_ps(x + i, _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m0, vx), _mm256_mul_ps(m4, vy)), m12));
+        _mm256_storeu_ps(y + i, _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m1, vx), _mm256_mul_ps(m5, vy)), m13));
+    }
+#elif defined(KERNELS_SSE2)
+    __m128 m0 = _mm_set1_ps(mat.m0), m4 = _mm_set1_ps(mat.m4), m12 = _mm_set1_ps(mat.m12);
+    __m128 m1 = _mm_set1_ps(mat.m1), m5 = _mm_set1_ps(mat.m5), m13 = _mm_set1_ps(mat.m13);
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 vx = _mm_loadu_ps(x + i);
+        __m128 vy = _mm_loadu_ps(y + i);
+        _mm_storeu_ps(x + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(m0, vx), _mm_mul_ps(m4, vy)), m12));
+        _mm_storeu_ps(y + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(m1, vx), _mm_mul_ps(m5, vy)), m13));
+    }
+#elif defined(KERNELS_NEON)
+    float32x4_t m12 = vdupq_n_f32(mat.m12);
+    float32x4_t m13 = vdupq_n_f32(mat.m13);
+    for (; i + 4 <= count; i += 4)
+    {
+        float32x4_t vx = vld1q_f32(x + i);
+        float32x4_t vy = vld1q_f32(y + i);
+        vst1q_f32(x + i, vaddq_f32(vaddq_f32(vmulq_n_f32(vx, mat.m0), vmulq_n_f32(vy, mat.m4)), m12));
+        vst1q_f32(y + i, vaddq_f32(vaddq_f32(vmulq_n_f32(vx, mat.m1), vmulq_n_f32(vy, mat.m5)), m13));
+    }
+#endif
+    for (; i < count; i++)
+    {
+        Vector2 v = Multiply(Vector2{ x[i], y[i] }, mat);
+        x[i] = v.x;
+        y[i] = v.y;
+    }
+}
+
+// -- POLYNOMIAL TRIG ---------------------------------
+// The trig and quaternion kernels are written once against a small set of lane operations and instantiated for the
+// widest vector type the build has and for plain float, which runs the tail. They need 32-bit integer
+// lanes for the quadrant logic, so an AVX build without AVX2 uses the SSE2 lanes.
+struct ScalarLanes
+{
+    using F = float;
+    using I = int32_t;
+    static const size_t WIDTH = 1;
+
+    static F Load(const float* p) { return *p; }
+    static void Store(float* p, F v) { *p = v; }
+    static F Splat(float v) { return v; }
+    static F Add(F a, F b) { return a + b; }
+    static F Sub(F a, F b) { return a - b; }
+    static F Mul(F a, F b) { return a * b; }
+    static F Div(F a, F b) { return a / b; }
+    static F Sqrt(F a) { return sqrtf(a); }
+    static F Min(F a, F b) { return a < b ? a : b; }
+    static F Max(F a, F b) { return a > b ? a : b; }
+
+    static uint32_t Bits(F v) { uint32_t bits; memcpy(&bits, &v, sizeof(bits)); return bits; }
+    static F FromBits(uint32_t bits) { F v; memcpy(&v, &bits, sizeof(v)); return v; }
+
+    // Masks are all-ones or all-zero bit patterns, as the vector compares produce.
+    static F Less(F a, F b) { return FromBits(a < b ? ~0u : 0u); }
+    static F Equal(F a, F b) { return FromBits(a == b ? ~0u : 0u); }
+    static bool All(F mask) { return Bits(mask) != 0; }
+    static F And(F a, F b) { return FromBits(Bits(a) & Bits(b)); }
+    static F Xor(F a, F b) { return FromBits(Bits(a) ^ Bits(b)); }
+    static F Select(F mask, F a, F b) { return FromBits((Bits(mask) & Bits(a)) | (~Bits(mask) & Bits(b))); }
+    static F Abs(F a) { return FromBits(Bits(a) & 0x7fffffffu); }
+    static F SignMask(F a) { return FromBits(Bits(a) >> 31 ? ~0u : 0u); }
+
+    static I RoundToInt(F v) { return (I)lrintf(v); }
+    static F ToFloat(I v) { return (F)v; }
+    static F BitMask(I v, int bit) { return FromBits(v & bit ? ~0u : 0u); }
+    static F Bit1ToSign(I v) { return FromBits(((uint32_t)v & 2u) << 30); }
+    static I AddInt(I v, int add) { return v + add; }
+};
+
+#if defined(__AVX2__)
+struct VectorLanes
+{
+    using F = __m256;
+    using I = __m256i;
+    static const size_t WIDTH = 8;
+
+    static F Load(const float* p) { return _mm256_loadu_ps(p); }
+    static void Store(float* p, F v) { _mm256_storeu_ps(p, v); }
+    static F Splat(float v) { return _mm256_set1_ps(v); }
+    static F Add(F a, F b) { return _mm256_add_ps(a, b); }
+    static F Sub(F a, F b) { return _mm256_sub_ps(a, b); }
+    static F Mul(F a, F b) { return _mm256_mul_ps(a, b); }
+    static F Div(F a, F b) { return _mm256_div_ps(a, b); }
+    static F Sqrt(F a) { return _mm256_sqrt_ps(a); }
+    static F Min(F a, F b) { return _mm256_min_ps(a, b); }
+    static F Max(F a, F b) { return _mm256_max_ps(a, b); }
+    static F Less(F a, F b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+    static F Equal(F a, F b) { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+    static bool All(F mask) { return _mm256_movemask_ps(mask) == 0xff; }
+    static F And(F a, F b) { return _mm256_and_ps(a, b); }
+    static F Xor(F a, F b) { return _mm256_xor_ps(a, b); }
+    static F Select(F mask, F a, F b) { return _mm256_blendv_ps(b, a, mask); }
+    static F Abs(F a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+    static F SignMask(F a) { return _mm256_castsi256_ps(_mm256_srai_epi32(_mm256_castps_si256(a), 31)); }
+    static I RoundToInt(F v) { return _mm256_cvtps_epi32(v); }
+    static F ToFloat(I v) { return _mm256_cvtepi32_ps(v); }
+    static F BitMask(I v, int bit)
+    {
+        I b = _mm256_set1_epi32(bit);
+        return _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(v, b), b));
+    }
+    static F Bit1ToSign(I v) { return _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(v, _mm256_set1_epi32(2)), 30)); }
+    static I AddInt(I v, int add) { return _mm256_add_epi32(v, _mm256_set1_epi32(add)); }
+};
+#elif defined(KERNELS_AVX) || defined(KERNELS_SSE2)
+struct VectorLanes
+{
+    using F = __m128;
+    using I = __m128i;
+    static const size_t WIDTH = 4;
+
+    static F Load(const float* p) { return _mm_loadu_ps(p); }
+    static void Store(float* p, F v) { _mm_storeu_ps(p, v); }
+    static F Splat(float v) { return _mm_set1_ps(v); }
+    static F Add(F a, F b) { return _mm_add_ps(a, b); }
+    static F Sub(F a, F b) { return _mm_sub_ps(a, b); }
+    static F Mul(F a, F b) { return _mm_mul_ps(a, b); }
+    static F Div(F a, F b) { return _mm_div_ps(a, b); }
+    static F Sqrt(F a) { return _mm_sqrt_ps(a); }
+    static F Min(F a, F b) { return _mm_min_ps(a, b); }
+    static F Max(F a, F b) { return _mm_max_ps(a, b); }
+    static F Less(F a, F b) { return _mm_cmplt_ps(a, b); }
+    static F Equal(F a, F b) { return _mm_cmpeq_ps(a, b); }
+    static bool All(F mask) { return _mm_movemask_ps(mask) == 0xf; }
+    static F And(F a, F b) { return _mm_and_ps(a, b); }
+    static F Xor(F a, F b) { return _mm_xor_ps(a, b); }
+    static F Select(F mask, F a, F b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+    static F Abs(F a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+    static F SignMask(F a) { return _mm_castsi128_ps(_mm_srai_epi32(_mm_castps_si128(a), 31)); }
+    static I RoundToInt(F v) { return _mm_cvtps_epi32(v); }
+    static F ToFloat(I v) { return _mm_cvtepi32_ps(v); }
+    static F BitMask(I v, int bit)
+    {
+        I b = _mm_set1_epi32(bit);
+        return _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(v, b), b));
+    }
+    static F Bit1ToSign(I v) { return _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(v, _mm_set1_epi32(2)), 30)); }
+    static I AddInt(I v, int add) { return _mm_add_epi32(v, _mm_set1_epi32(add)); }
+};
+#elif defined(KERNELS_NEON)
+struct VectorLanes
+{
+    using F = float32x4_t;
+    using I = int32x4_t;
+    static const size_t WIDTH = 4;
+
+    static F Load(const float* p) { return vld1q_f32(p); }
+    static void Store(float* p, F v) { vst1q_f32(p, v); }
+    static F Splat(float v) { return vdupq_n_f32(v); }
+    static F Add(F a, F b) { return vaddq_f32(a, b); }
+    static F Sub(F a, F b) { return vsubq_f32(a, b); }
+    static F Mul(F a, F b) { return vmulq_f32(a, b); }
+    static F Div(F a, F b) { return vdivq_f32(a, b); }
+    static F Sqrt(F a) { return vsqrtq_f32(a); }
+    static F Min(F a, F b) { return vminq_f32(a, b); }
+    static F Max(F a, F b) { return vmaxq_f32(a, b); }
+    static F Less(F a, F b) { return vreinterpretq_f32_u32(vcltq_f32(a, b)); }
+    static F Equal(F a, F b) { return vreinterpretq_f32_u32(vceqq_f32(a, b)); }
+    static bool All(F mask) { return vminvq_u32(vreinterpretq_u32_f32(mask)) != 0; }
+    static F And(F a, F b) { return vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b))); }
+    static F Xor(F a, F b) { return vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b))); }
+    static F Select(F mask, F a, F b) { return vbslq_f32(vreinterpretq_u32_f32(mask), a, b); }
+    static F Abs(F a) { return vabsq_f32(a); }
+    static F SignMask(F a) { return vreinterpretq_f32_s32(vshrq_n_s32(vreinterpretq_s32_f32(a), 31)); }
+    static I RoundToInt(F v) { return vcvtnq_s32_f32(v); }
+    static F ToFloat(I v) { return vcvtq_f32_s32(v); }
+    static F BitMask(I v, int bit) { return vreinterpretq_f32_u32(vtstq_s32(v, vdupq_n_s32(bit))); }
+    static F Bit1ToSign(I v) { return vreinterpretq_f32_s32(vshlq_n_s32(vandq_s32(v, vdupq_n_s32(2)), 30)); }
+    static I AddInt(I v, int add) { return vaddq_s32(v, vdupq_n_s32(add)); }
+};
+#else
+using VectorLanes = ScalarLanes;
+#endif
+
+// sin and cos of one set of lanes. The angle is reduced to r in [-pi/4, pi/4] by the nearest multiple
+// q of pi/2, subtracted in three parts so q * part stays exact (Cody-Waite). Minimax polynomials for
+// sin r and cos r (Cephes' sinf/cosf coefficients) then get swapped and negated by q's quadrant.
+template<typename L>
+static void SinCosLanes(typename L::F angle, typename L::F& sine, typename L::F& cosine)
+{
+    using F = typename L::F;
+    typename L::I q = L::RoundToInt(L::Mul(angle, L::Splat(0.636619772f)));
+    F qf = L::ToFloat(q);
+    F r = L::Sub(angle, L::Mul(qf, L::Splat(1.5703125f)));
+    r = L::Sub(r, L::Mul(qf, L::Splat(4.837512969970703125e-4f)));
+    r = L::Sub(r, L::Mul(qf, L::Splat(7.549789948768648e-8f)));
+    F z = L::Mul(r, r);
+
+    F sinPoly = L::Add(L::Mul(z, L::Splat(-1.9515295891e-4f)), L::Splat(8.3321608736e-3f));
+    sinPoly = L::Add(L::Mul(sinPoly, z), L::Splat(-1.6666654611e-1f));
+    F sinR = L::Add(r, L::Mul(L::Mul(sinPoly, z), r));
+
+    F cosPoly = L::Add(L::Mul(z, L::Splat(2.443315711809948e-5f)), L::Splat(-1.388731625493765e-3f));
+    cosPoly = L::Add(L::Mul(cosPoly, z), L::Splat(4.166664568298827e-2f));
+    F cosR = L::Add(L::Sub(L::Splat(1.0f), L::Mul(z, L::Splat(0.5f))), L::Mul(L::Mul(cosPoly, z), z));
+
+    // Odd quadrants swap sin and cos; sin is negated in quadrants 2 and 3, cos in quadrants 1 and 2.
+    F swap = L::BitMask(q, 1);
+    sine = L::Xor(L::Select(swap, cosR, sinR), L::Bit1ToSign(q));
+    cosine = L::Xor(L::Select(swap, sinR, cosR), L::Bit1ToSign(L::AddInt(q, 1)));
+}
+
+// atan2 of one set of lanes. atan(min/max) of the absolute values covers [0, pi/4]; above tan(pi/8)
+// the identity atan t = pi/4 + atan((t - 1) / (t + 1)) brings the polynomial's input back under
+// tan(pi/8), where Cephes' atanf polynomial holds. Octant and sign fix-ups come from the comparisons
+// and sign bits, so -0 behaves like atan2f.
+template<typename L>
+static typename L::F Atan2Lanes(typename L::F y, typename L::F x)
+{
+    using F = typename L::F;
+    F ax = L::Abs(x);
+    F ay = L::Abs(y);
+    F high = L::Max(ax, ay);
+    F t = L::And(L::Div(L::Min(ax, ay), high), L::Less(L::Splat(0.0f), high));   // 0 / 0 gives 0.
+
+    F reduce = L::Less(L::Splat(0.414213562f), t);
+    t = L::Select(reduce, L::Div(L::Sub(t, L::Splat(1.0f)), L::Add(t, L::Splat(1.0f))), t);
+    F z = L::Mul(t, t);
+    F poly = L::Add(L::Mul(z, L::Splat(8.05374449538e-2f)), L::Splat(-1.38776856032e-1f));
+    poly = L::Add(L::Mul(poly, z), L::Splat(1.99777106478e-1f));
+    poly = L::Add(L::Mul(poly, z), L::Splat(-3.33329491539e-1f));
+    F angle = L::Add(L::Add(L::Mul(L::Mul(poly, z), t), t), L::And(reduce, L::Splat(0.785398163f)));
+
+    angle = L::Select(L::Less(ax, ay), L::Sub(L::Splat(1.57079633f), angle), angle);
+    angle = L::Select(L::SignMask(x), L::Sub(L::Splat(3.14159265f), angle), angle);
+    return L::Xor(angle, L::And(y, L::Splat(-0.0f)));
+}
+
+template<typename L>
+static size_t SinCosLoop(const float* angles, float* sines, float* cosines, size_t i, size_t count)
+{
+    for (; i + L::WIDTH <= count; i += L::WIDTH)
+    {
+        typename L::F sine;
+        typename L::F cosine;
+        SinCosLanes<L>(L::Load(angles + i), sine, cosine);
+        L::Store(sines + i, sine);
+        L::Store(cosines + i, cosine);
+    }
+    return i;
+}
+
+void SinCosKernel(const float* angles, float* sines, float* cosines, size_t count)
+{
+    size_t i = SinCosLoop<VectorLanes>(angles, sines, cosines, 0, count);
+    SinCosLoop<ScalarLanes>(angles, sines, cosines, i, count);
+}
+
+template<typename L>
+static size_t Atan2Loop(const float* y, const float* x, float* angles, size_t i, size_t count)
+{
+    for (; i + L::WIDTH <= count; i += L::WIDTH)
+        L::Store(angles + i, Atan2Lanes<L>(L::Load(y + i), L::Load(x + i)));
+    return i;
+}
+
+void Atan2Kernel(const float* y, const float* x, float* angles, size_t count)
+{
+    size_t i = Atan2Loop<VectorLanes>(y, x, angles, 0, count);
+    Atan2Loop<ScalarLanes>(y, x, angles, i, count);
+}
+
+template<typename L>
+static size_t RotateLoop(float* x, float* y, const float* angles, size_t i, size_t count)
+{
+    for (; i + L::WIDTH <= count; i += L::WIDTH)
+    {
+        typename L::F sine;
+        typename L::F cosine;
+        SinCosLanes<L>(L::Load(angles + i), sine, cosine);
+        typename L::F vx = L::Load(x + i);
+        typename L::F vy = L::Load(y + i);
+        L::Store(x + i, L::Sub(L::Mul(vx, cosine), L::Mul(vy, sine)));
+        L::Store(y + i, L::Add(L::Mul(vx, sine), L::Mul(vy, cosine)));
+    }
+    return i;
+}
+
+void RotateKernel(float* x, float* y, const float* angles, size_t count)
+{
+    size_t i = RotateLoop<VectorLanes>(x, y, angles, 0, count);
+    RotateLoop<ScalarLanes>(x, y, angles, i, count);
+}
+
+// -- QUATERNION INTERPOLATION ---------------------------------
+template<typename L>
+struct QuaternionLanes
+{
+    typename L::F x;
+    typename L::F y;
+    typename L::F z;
+    typename L::F w;
+};
+
+template<typename L>
+static QuaternionLanes<L> LoadQuaternions(const QuaternionPlanes& q, size_t i)
+{
+    return { L::Load(q.x + i), L::Load(q.y + i), L::Load(q.z + i), L::Load(q.w + i) };
+}
+
+template<typename L>
+static void StoreQuaternions(const QuaternionPlanes& q, size_t i, const QuaternionLanes<L>& v)
+{
+    L::Store(q.x + i, v.x);
+    L::Store(q.y + i, v.y);
+    L::Store(q.z + i, v.z);
+    L::Store(q.w + i, v.w);
+}
+
+template<typename L>
+static typename L::F DotLanes(const QuaternionLanes<L>& a, const QuaternionLanes<L>& b)
+{
+    return L::Add(L::Add(L::Add(L::Mul(a.x, b.x), L::Mul(a.y, b.y)), L::Mul(a.z, b.z)), L::Mul(a.w, b.w));
+}
+
+template<typename L>
+static QuaternionLanes<L> SelectLanes(typename L::F mask, const QuaternionLanes<L>& a, const QuaternionLanes<L>& b)
+{
+    return { L::Select(mask, a.x, b.x), L::Select(mask, a.y, b.y), L::Select(mask, a.z, b.z), L::Select(mask, a.w, b.w) };
+}
+
+// Nlerp's lerp and normalize, operation for operation.
+template<typename L>
+static QuaternionLanes<L> NlerpLanes(const QuaternionLanes<L>& from, const QuaternionLanes<L>& to, typename L::F amount)
+{
+    using F = typename L::F;
+    QuaternionLanes<L> q;
+    q.x = L::Add(from.x, L::Mul(amount, L::Sub(to.x, from.x)));
+    q.y = L::Add(from.y, L::Mul(amount, L::Sub(to.y, from.y)));
+    q.z = L::Add(from.z, L::Mul(amount, L::Sub(to.z, from.z)));
+    q.w = L::Add(from.w, L::Mul(amount, L::Sub(to.w, from.w)));
+
+    F length = L::Sqrt(DotLanes<L>(q, q));
+    length = L::Select(L::Equal(length, L::Splat(0.0f)), L::Splat(1.0f), length);
+    F inverse = L::Div(L::Splat(1.0f), length);
+    return { L::Mul(q.x, inverse), L::Mul(q.y, inverse), L::Mul(q.z, inverse), L::Mul(q.w, inverse) };
+}
+
+// Slerp's cases as lane selects. When every lane is in the Nlerp range the trig is skipped. Slerp's
+// midpoint case for a tiny sin(theta / 2) can't be reached below cos 0.95, so it has no lanes here.
+template<typename L>
+static QuaternionLanes<L> SlerpLanes(const QuaternionLanes<L>& from, QuaternionLanes<L> to, typename L::F amount)
+{
+    using F = typename L::F;
+    F cosHalfTheta = DotLanes<L>(from, to);
+    F flip = L::And(L::Less(cosHalfTheta, L::Splat(0.0f)), L::Splat(-0.0f));
+    to = { L::Xor(to.x, flip), L::Xor(to.y, flip), L::Xor(to.z, flip), L::Xor(to.w, flip) };
+    cosHalfTheta = L::Xor(cosHalfTheta, flip);
+
+    QuaternionLanes<L> result = NlerpLanes<L>(from, to, amount);
+    F near = L::Less(L::Splat(0.95f), cosHalfTheta);
+    if (!L::All(near))
+    {
+        // acos as atan2 of sine over cosine, the sine being non-negative.
+        F sinHalfTheta = L::Sqrt(L::Sub(L::Splat(1.0f), L::Mul(cosHalfTheta, cosHalfTheta)));
+        F halfTheta = Atan2Lanes<L>(sinHalfTheta, cosHalfTheta);
+        F sineA;
+        F sineB;
+        F unused;
+        SinCosLanes<L>(L::Mul(L::Sub(L::Splat(1.0f), amount), halfTheta), sineA, unused);
+        SinCosLanes<L>(L::Mul(amount, halfTheta), sineB, unused);
+        F ratioA = L::Div(sineA, sinHalfTheta);
+        F ratioB = L::Div(sineB, sinHalfTheta);
+        QuaternionLanes<L> slerp;
+        slerp.x = L::Add(L::Mul(from.x, ratioA), L::Mul(to.x, ratioB));
+        slerp.y = L::Add(L::Mul(from.y, ratioA), L::Mul(to.y, ratioB));
+        slerp.z = L::Add(L::Mul(from.z, ratioA), L::Mul(to.z, ratioB));
+        slerp.w = L::Add(L::Mul(from.w, ratioA), L::Mul(to.w, ratioB));
+        result = SelectLanes<L>(near, result, slerp);
+    }
+
+    // cos >= 1, written as above the float just below 1 so NaN lanes stay NaN as in Slerp.
+    return SelectLanes<L>(L::Less(L::Splat(0.99999994f), cosHalfTheta), from, result);
+}
+
+template<typename L>
+static size_t NlerpLoop(const QuaternionPlanes& from, const QuaternionPlanes& to, const QuaternionPlanes& out,
+    float amount, size_t i, size_t count)
+{
+    typename L::F a = L::Splat(amount);
+    for (; i + L::WIDTH <= count; i += L::WIDTH)
+        StoreQuaternions<L>(out, i, NlerpLanes<L>(LoadQuaternions<L>(from, i), LoadQuaternions<L>(to, i), a));
+    return i;
+}
+
+void NlerpKernel(const QuaternionPlanes& from, const QuaternionPlanes& to, const QuaternionPlanes& out, float amount, size_t count)
+{
+    size_t i = NlerpLoop<VectorLanes>(from, to, out, amount, 0, count);
+    NlerpLoop<ScalarLanes>(from, to, out, amount, i, count);
+}
+
+template<typename L>
+static size_t SlerpLoop(const QuaternionPlanes& from, const QuaternionPlanes& to, const QuaternionPlanes& out,
+    float amount, size_t i, size_t count)
+{
+    typename L::F a = L::Splat(amount);
+    for (; i + L::WIDTH <= count; i += L::WIDTH)
+        StoreQuaternions<L>(out, i, SlerpLanes<L>(LoadQuaternions<L>(from, i), LoadQuaternions<L>(to, i), a));
+    return i;
+}
+
+void SlerpKernel(const QuaternionPlanes& from, const QuaternionPlanes& to, const QuaternionPlanes& out, float amount, size_t count)
+{
+    size_t i = SlerpLoop<VectorLanes>(from, to, out, amount, 0, count);
+    SlerpLoop<ScalarLanes>(from, to, out, amount, i, count);
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include "Math.h"
+
+#include <cstddef>
+
+// Batch kernels over structure-of-arrays columns. Uses AVX when the build enables it
+// (/arch:AVX or -mavx), SSE2 on x64, NEON on ARM64, and a scalar loop otherwise.
+// Arrays may alias only if they are the same array; no alignment is required.
+// Each kernel does the same float operations in the same order as its Math.h counterpart, so results
+// match it exactly unless the compiler contracts the scalar version's multiply-adds into FMAs, which
+// moves the scalar result by a few ulp.
+
+// x[i] += vx[i] * scale, y[i] += vy[i] * scale
+void MoveKernel(float* x, float* y, const float* vx, const float* vy, float scale, size_t count);
+
+// values[i] += add
+void AddKernel(float* values, float add, size_t count);
+
+// values[i] *= scale
+void ScaleKernel(float* values, float scale, size_t count);
+
+// (x[i], y[i]) = Normalize((x[i], y[i])); zero-length vectors become zero.
+void NormalizeKernel(float* x, float* y, size_t count);
+
+// out[i] = DistanceSqr(point, (x[i], y[i]))
+void DistanceSqrKernel(Vector2 point, const float* x, const float* y, float* out, size_t count);
+
+// out[i] = Distance(point, (x[i], y[i]))
+void DistanceKernel(Vector2 point, const float* x, const float* y, float* out, size_t count);
+
+// (x[i], y[i]) = Lerp((x[i], y[i]), (toX[i], toY[i]), amount)
+void LerpKernel(float* x, float* y, const float* toX, const float* toY, float amount, size_t count);
+
+// (x[i], y[i]) = Multiply((x[i], y[i]), mat): the 2D points transformed by one matrix, z taken as 0.
+void TransformKernel(float* x, float* y, const Matrix& mat, size_t count);
+
+// Polynomial trig. Angles are in radians. Tail elements use the same polynomials as the vector lanes,
+// so a result doesn't depend on where in the array it sits. Worst absolute error against sinf, cosf
+// and atan2f, from main --bench trig:
+//   sin/cos   1.2e-7 (an ulp near 1), for |angle| up to 1e4 (the range reduction stays exact to ~1e5)
+//   atan2     2.4e-7 radians
+// Inputs must be finite. atan2 of (0, 0) is 0, and signed zeros follow atan2f.
+
+// sines[i] = sinf(angles[i]), cosines[i] = cosf(angles[i])
+void SinCosKernel(const float* angles, float* sines, float* cosines, size_t count);
+
+// angles[i] = atan2f(y[i], x[i])
+void Atan2Kernel(const float* y, const float* x, float* angles, size_t count);
+
+// (x[i], y[i]) = Rotate((x[i], y[i]), angles[i])
+void RotateKernel(float* x, float* y, const float* angles, size_t count);
+
+// count quaternions stored as one array per component. Input and output planes follow the aliasing
+// rule above: out may be from or to, but not overlap them otherwise.
+struct QuaternionPlanes
+{
+    float* x;
+    float* y;
+    float* z;
+    float* w;
+};
+
+// out[i] = Nlerp(from[i], to[i], amount), bit-identical to Nlerp.
+void NlerpKernel(const QuaternionPlanes& from, const QuaternionPlanes& to, const QuaternionPlanes& out, float amount, size_t count);
+
+// out[i] = Slerp(from[i], to[i], amount). Pairs within Slerp's Nlerp range (cos of the half angle
+// above 0.95) take the Nlerp path and match Slerp exactly; wider ones use the polynomial sin and
+// atan2 above and land within 3e-7 of Slerp. A group of lanes all in the Nlerp range skips the trig.
+void SlerpKernel(const QuaternionPlanes& from, const QuaternionPlanes& to, const QuaternionPlanes& out, float amount, size_t count);
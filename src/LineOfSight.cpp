@@ -0,0 +1,82 @@
+#include "LineOfSight.h"
+
+#include <cstdlib>
+
+// Walks the tiles between two tile centres, calling opaque(row, col) on each after the first.
+// The segment crosses a column line at (0.5 + ix) / dx of its length and a row line at (0.5 + iy) / dy;
+// comparing those fractions cross-multiplied picks the next line to cross, and equality means a corner.
+template<typename Opaque>
+static bool TraceRay(Cell from, Cell to, Opaque&& opaque)
+{
+    int dx = std::abs(to.col - from.col);
+    int dy = std::abs(to.row - from.row);
+    int stepX = to.col > from.col ? 1 : -1;
+    int stepY = to.row > from.row ? 1 : -1;
+    Cell cell = from;
+    for (int ix = 0, iy = 0; ix < dx || iy < dy;)
+    {
+        long long decision = (long long)(1 + 2 * ix) * dy - (long long)(1 + 2 * iy) * dx;
+        if (decision == 0)
+        {
+            if (opaque(cell.row, cell.col + stepX) || opaque(cell.row + stepY, cell.col))
+                return false;
+            cell.col += stepX;
+            cell.row += stepY;
+            ix++;
+            iy++;
+        }
+        else if (decision < 0)
+        {
+            cell.col += stepX;
+            ix++;
+        }
+        else
+        {
+            cell.row += stepY;
+            iy++;
+        }
+        if (opaque(cell.row, cell.col))
+            return false;
+    }
+    return true;
+}
+
+bool HasLineOfSight(const ChunkedTileMap& tiles, Cell from, Cell to)
+{
+    return TraceRay(from, to, [&tiles](int row, int col) {
+        return !tiles.Contains({ row, col }) || BlocksSight(tiles.Get(row, col));
+    });
+}
+
+void VisibilityMask::Build(const ChunkedTileMap& tiles, Cell center, int radius)
+{
+    origin = { center.row - radius, center.col - radius };
+    size = 2 * radius + 1;
+    bits.assign(((size_t)size * size + 63) / 64, 0);
+
+    // Rays from the centre stay inside the square, so one read per tile serves all of them.
+    std::vector<uint8_t> opaque((size_t)size * size);
+    for (int row = 0; row < size; row++)
+    {
+        for (int col = 0; col < size; col++)
+        {
+            Cell cell = { origin.row + row, origin.col + col };
+            opaque[row * size + col] = !tiles.Contains(cell) || BlocksSight(tiles.Get(cell));
+        }
+    }
+
+    auto blocked = [&](int row, int col) {
+        return opaque[(row - origin.row) * size + (col - origin.col)] != 0;
+    };
+    for (int row = 0; row < size; row++)
+    {
+        for (int col = 0; col < size; col++)
+        {
+            // The centre tile traces no ray, so like HasLineOfSight it only has to be on the map.
+            int index = row * size + col;
+            bool visible = index == radius * size + radius ? tiles.Contains(center) : TraceRay(center, { origin.row + row, origin.col + col }, blocked);
+            if (visible)
+                bits[index >> 6] |= 1ull << (index & 63);
+        }
+    }
+}
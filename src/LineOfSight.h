@@ -0,0 +1,54 @@
+#pragma once
+#include "ChunkedTileMap.h"
+#include "Grid.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Rock walls off turret sight; everything else, turrets included, can be seen past.
+inline bool BlocksSight(int tile)
+{
+    return tile == ROCK;
+}
+
+// Range in whole tiles, rounded up: from anywhere in a turret's tile, any point strictly inside its
+// range circle lies in a tile at most this many rows and columns away.
+inline int SightRadius(float range)
+{
+    return (int)ceilf(range / TILE_SIZE);
+}
+
+// Grid DDA from the centre of one tile to the centre of another. Steps through every tile the
+// segment crosses (the supercover line), with exact integer decisions so the result doesn't depend on
+// float rounding. Sight is blocked if any crossed tile after `from` blocks, `to` included. A segment
+// through a tile corner counts as touching both tiles beside the corner.
+bool HasLineOfSight(const ChunkedTileMap& tiles, Cell from, Cell to);
+
+// Which tiles one turret can see into, over the square of tiles within a sight radius. Built by
+// tracing HasLineOfSight to every tile in the square against one copy of its tiles, so the per-pair
+// check during targeting is a bit test. Tiles off the map or outside the square are never visible.
+class VisibilityMask
+{
+public:
+    void Build(const ChunkedTileMap& tiles, Cell center, int radius);
+
+    bool Covers(Cell cell) const
+    {
+        return cell.row >= origin.row && cell.row < origin.row + size && cell.col >= origin.col && cell.col < origin.col + size;
+    }
+    bool Visible(Cell cell) const
+    {
+        if (!Covers(cell))
+            return false;
+        int bit = (cell.row - origin.row) * size + (cell.col - origin.col);
+        return (bits[bit >> 6] >> (bit & 63)) & 1;
+    }
+
+    size_t MemoryBytes() const { return bits.capacity() * sizeof(uint64_t); }
+
+private:
+    Cell origin{ 0, 0 };            // Top-left tile of the square.
+    int size = 0;                   // Tiles per side, 2 * radius + 1.
+    std::vector<uint64_t> bits;     // One bit per tile of the square, row-major.
+};
@@ -0,0 +1,268 @@
+#include "MapFile.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Tiles start on a cache line; the turret list on its natural alignment.
+static const uint64_t TILE_ALIGN = 64;
+static const uint64_t TURRET_ALIGN = alignof(MapCell);
+
+static uint64_t AlignUp(uint64_t value, uint64_t align)
+{
+    return (value + align - 1) / align * align;
+}
+
+bool MapFile::Fail(const char* message)
+{
+    Close();
+    error = message;
+    return false;
+}
+
+bool MapFile::Open(const char* path)
+{
+    Close();
+    if (!file.Open(path))
+        return Fail("can't open or map the file");
+    if (file.Size() < sizeof(MapHeader))
+        return Fail("file is smaller than the header");
+
+    header = (const MapHeader*)file.Data();
+    if (memcmp(header->magic, MAP_MAGIC, sizeof(MAP_MAGIC)) != 0)
+        return Fail("not a map file");
+    if (header->version != MAP_VERSION)
+        return Fail("unsupported map version");
+    if (header->rows <= 0 || header->cols <= 0)
+        return Fail("bad map size");
+
+    uint64_t tileBytes = (uint64_t)header->rows * (uint64_t)header->cols;
+    uint64_t turretBytes = (uint64_t)header->turretCount * sizeof(MapCell);
+    if (header->tileOffset > file.Size() || tileBytes > file.Size() - header->tileOffset)
+        return Fail("tile plane runs past the end of the file");
+    if (header->turretOffset % TURRET_ALIGN != 0 || header->turretOffset > file.Size() ||
+        turretBytes > file.Size() - header->turretOffset)
+        return Fail("turret list runs past the end of the file");
+
+    TileView tiles = Tiles();
+    if (!tiles.Contains(Spawn()) || !tiles.Contains(Goal()))
+        return Fail("spawn or goal is off the map");
+
+    // Every consumer indexes by tile type, so one bad byte is worth a pass over the plane. The
+    // same pass counts TURRET tiles for the turret list check below. Both are plain reductions,
+    // which compilers turn into wide byte compares; the count runs in byte-sized blocks so it can
+    // stay in byte lanes too.
+    const uint8_t* bytes = tiles.Data();
+    uint8_t highest = 0;
+    uint64_t turretTiles = 0;
+    for (uint64_t block = 0; block < tileBytes; block += UINT8_MAX)
+    {
+        uint64_t end = std::min(tileBytes, block + UINT8_MAX);
+        uint8_t count = 0;
+        for (uint64_t i = block; i < end; i++)
+        {
+            highest = std::max(highest, bytes[i]);
+            count += bytes[i] == TURRET;
+        }
+        turretTiles += count;
+    }
+    if (highest >= COUNT)
+        return Fail("unknown tile type");
+
+    // The list must be exactly the TURRET tiles in row-major order: as many entries as tiles, each
+    // on a TURRET tile and after the one before, so none repeats.
+    if (turretTiles != TurretCount())
+        return Fail("turret list doesn't match the TURRET tiles");
+    uint64_t previous = 0;
+    for (size_t i = 0; i < TurretCount(); i++)
+    {
+        const MapCell& turret = Turrets()[i];
+        if (!tiles.Contains({ turret.row, turret.col }))
+            return Fail("turret is off the map");
+        uint64_t offset = (uint64_t)turret.row * header->cols + turret.col;
+        if (tiles.Get(turret.row, turret.col) != TURRET || (i > 0 && offset <= previous))
+            return Fail("turret list doesn't match the TURRET tiles");
+        previous = offset;
+    }
+    return true;
+}
+
+TileView MapFile::Tiles() const
+{
+    return { header->rows, header->cols, file.Data() + header->tileOffset };
+}
+
+bool WriteMapFile(const char* path, TileView tiles, Cell spawn, Cell goal)
+{
+    std::vector<MapCell> turrets;
+    for (int row = 0; row < tiles.Rows(); row++)
+    {
+        for (int col = 0; col < tiles.Cols(); col++)
+        {
+            if (tiles.Get(row, col) == TURRET)
+                turrets.push_back({ row, col });
+        }
+    }
+
+    MapHeader header = {};
+    memcpy(header.magic, MAP_MAGIC, sizeof(MAP_MAGIC));
+    header.version = MAP_VERSION;
+    header.rows = tiles.Rows();
+    header.cols = tiles.Cols();
+    header.spawn = { spawn.row, spawn.col };
+    header.goal = { goal.row, goal.col };
+    header.turretCount = (uint32_t)turrets.size();
+    header.tileOffset = AlignUp(sizeof(MapHeader), TILE_ALIGN);
+    uint64_t tileBytes = (uint64_t)tiles.Rows() * tiles.Cols();
+    header.turretOffset = AlignUp(header.tileOffset + tileBytes, TURRET_ALIGN);
+
+    FILE* file = fopen(path, "wb");
+    if (!file)
+        return false;
+    static const uint8_t padding[TILE_ALIGN] = {};
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    ok = ok && fwrite(padding, 1, header.tileOffset - sizeof(header), file) == header.tileOffset - sizeof(header);
+    ok = ok && fwrite(tiles.Data(), 1, tileBytes, file) == tileBytes;
+    ok = ok && fwrite(padding, 1, header.turretOffset - header.tileOffset - tileBytes, file) ==
+        header.turretOffset - header.tileOffset - tileBytes;
+    ok = ok && (turrets.empty() || fwrite(turrets.data(), sizeof(MapCell), turrets.size(), file) == turrets.size());
+    return fclose(file) == 0 && ok;
+}
+
+// Text map errors carry a line and column, so they are formatted into this buffer.
+static char textError[96];
+
+static const char* TextError(const char* message, int line, int column)
+{
+    snprintf(textError, sizeof(textError), "line %d, column %d: %s", line, column, message);
+    return textError;
+}
+
+// Whitespace plus the commas and braces of the LEVEL_TILES literal.
+static bool IsSeparator(char c)
+{
+    return isspace((unsigned char)c) || c == ',' || c == '{' || c == '}';
+}
+
+bool ReadTextMap(const char* path, TileGrid<>& tiles, Cell& spawn, Cell& goal, const char*& error)
+{
+    FILE* file = fopen(path, "rb");
+    if (!file)
+    {
+        error = "can't open the text map";
+        return false;
+    }
+    std::string text;
+    char buffer[1 << 16];
+    size_t count;
+    while ((count = fread(buffer, 1, sizeof(buffer), file)) > 0)
+        text.append(buffer, count);
+    fclose(file);
+
+    std::vector<uint8_t> values;
+    int rows = 0;
+    int cols = -1;
+    bool haveSpawn = false;
+    bool haveGoal = false;
+    int lineNumber = 0;
+    size_t begin = 0;
+    while (begin < text.size())
+    {
+        lineNumber++;
+        size_t end = text.find('\n', begin);
+        if (end == std::string::npos)
+            end = text.size();
+        std::string line = text.substr(begin, end - begin);
+        begin = end + 1;
+        size_t comment = line.find("//");
+        if (comment != std::string::npos)
+            line.resize(comment);
+
+        int row;
+        int col;
+        if (sscanf(line.c_str(), " spawn %d %d", &row, &col) == 2)
+        {
+            spawn = { row, col };
+            haveSpawn = true;
+            continue;
+        }
+        if (sscanf(line.c_str(), " goal %d %d", &row, &col) == 2)
+        {
+            goal = { row, col };
+            haveGoal = true;
+            continue;
+        }
+
+        int rowLength = 0;
+        for (const char* c = line.c_str(); *c;)
+        {
+            if (IsSeparator(*c))
+            {
+                c++;
+                continue;
+            }
+            int column = (int)(c - line.c_str()) + 1;
+            if (!isdigit((unsigned char)*c))
+            {
+                error = TextError("expected a tile number", lineNumber, column);
+                return false;
+            }
+            char* next;
+            long value = strtol(c, &next, 10);
+            if (value >= COUNT)
+            {
+                error = TextError("unknown tile type", lineNumber, column);
+                return false;
+            }
+            values.push_back((uint8_t)value);
+            rowLength++;
+            c = next;
+        }
+        if (rowLength == 0)
+            continue;
+        if (cols >= 0 && rowLength != cols)
+        {
+            error = TextError("rows have different lengths", lineNumber, 1);
+            return false;
+        }
+        cols = rowLength;
+        rows++;
+    }
+
+    if (rows == 0)
+    {
+        error = "no tile rows";
+        return false;
+    }
+    if (!haveSpawn || !haveGoal)
+    {
+        error = "missing spawn or goal line";
+        return false;
+    }
+    tiles = TileGrid<>(rows, cols, values.data());
+    if (!tiles.Contains(spawn) || !tiles.Contains(goal))
+    {
+        error = "spawn or goal is off the map";
+        return false;
+    }
+    return true;
+}
+
+bool ConvertTextMap(const char* textPath, const char* mapPath, const char*& error)
+{
+    TileGrid<> tiles;
+    Cell spawn;
+    Cell goal;
+    if (!ReadTextMap(textPath, tiles, spawn, goal, error))
+        return false;
+    if (!WriteMapFile(mapPath, tiles, spawn, goal))
+    {
+        error = "can't write the map file";
+        return false;
+    }
+    return true;
+}
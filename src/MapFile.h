@@ -0,0 +1,79 @@
+#pragma once
+#include "Grid.h"
+#include "MappedFile.h"
+
+#include <cstddef>
+#include <cstdint>
+
+// Binary map format. Little-endian; offsets count from the start of the file.
+//
+//   MapHeader      56 bytes
+//   tiles          rows * cols bytes at tileOffset, one TileType each, row-major (the TileGrid layout)
+//   turrets        turretCount MapCells at turretOffset, the TURRET tiles in row-major order
+//
+// Bump MAP_VERSION whenever the layout changes; older files are rejected rather than misread.
+const char MAP_MAGIC[4] = { 'T', 'D', 'M', 'P' };
+const uint32_t MAP_VERSION = 1;
+
+struct MapCell
+{
+    int32_t row;
+    int32_t col;
+};
+
+struct MapHeader
+{
+    char magic[4];
+    uint32_t version;
+    int32_t rows;
+    int32_t cols;
+    MapCell spawn;
+    MapCell goal;
+    uint32_t turretCount;
+    uint32_t reserved;
+    uint64_t tileOffset;
+    uint64_t turretOffset;
+};
+
+static_assert(sizeof(MapHeader) == 56, "MapHeader layout is part of the file format");
+
+// A map file mapped into memory. Tiles() and Turrets() point straight into the mapping: nothing is
+// parsed or copied, so opening costs a header check plus one pass that makes sure every tile byte
+// is a valid TileType and counts the TURRET tiles. The turret list must be exactly those tiles in
+// row-major order, so callers can take turrets from either. The views stay valid until the MapFile
+// is closed or destroyed.
+class MapFile
+{
+public:
+    bool Open(const char* path);
+    void Close() { file.Close(); header = nullptr; }
+
+    // Why the last Open failed.
+    const char* Error() const { return error; }
+
+    TileView Tiles() const;
+    Cell Spawn() const { return { header->spawn.row, header->spawn.col }; }
+    Cell Goal() const { return { header->goal.row, header->goal.col }; }
+    const MapCell* Turrets() const { return (const MapCell*)(file.Data() + header->turretOffset); }
+    size_t TurretCount() const { return header->turretCount; }
+
+private:
+    bool Fail(const char* message);
+
+    MappedFile file;
+    const MapHeader* header = nullptr;
+    const char* error = "";
+};
+
+// Writes tiles, spawn and goal as a binary map. The turret list is taken from the TURRET tiles.
+bool WriteMapFile(const char* path, TileView tiles, Cell spawn, Cell goal);
+
+// Reads a plain-text map laid out like the LEVEL_TILES literal: one line of tile numbers per row
+// (whitespace, commas, braces and // comments are ignored) plus "spawn <row> <col>" and
+// "goal <row> <col>" lines. Any other character, a sign included, is an error. On failure returns
+// false with a message in error; messages about the grid name the line and column and stay valid
+// until the next call.
+bool ReadTextMap(const char* path, TileGrid<>& tiles, Cell& spawn, Cell& goal, const char*& error);
+
+// ReadTextMap followed by WriteMapFile.
+bool ConvertTextMap(const char* textPath, const char* mapPath, const char*& error);
@@ -0,0 +1,30 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// A whole file mapped read-only into memory (MapViewOfFile on Windows, mmap elsewhere). Pages are
+// read in by the OS on first touch, so opening costs the same for any file size.
+// Kept in its own translation unit so the OS headers never meet raylib's.
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Unmaps any previous file first. Empty files fail to map.
+    bool Open(const char* path);
+    void Close();
+
+    const uint8_t* Data() const { return data; }
+    size_t Size() const { return size; }
+
+private:
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+#if defined(_WIN32)
+    void* file = nullptr;
+    void* mapping = nullptr;
+#endif
+};
@@ -0,0 +1,5 @@
+#pragma once
+#include <cstddef>
+
+// Peak resident set size of the whole process so far, in bytes. 0 if the platform can't report it.
+size_t PeakResidentBytes();
@@ -0,0 +1,49 @@
+#include "Path.h"
+
+#include <algorithm>
+
+Path::Path(const std::vector<Cell>& waypoints)
+{
+    if (waypoints.empty())
+        return;
+
+    origin = TileCenter(waypoints[0].row, waypoints[0].col);
+    for (size_t i = 0; i + 1 < waypoints.size(); i++)
+    {
+        Vector2 from = TileCenter(waypoints[i].row, waypoints[i].col);
+        Vector2 to = TileCenter(waypoints[i + 1].row, waypoints[i + 1].col);
+        float segmentLength = Distance(from, to);
+        if (segmentLength <= 0.0f)
+            continue;
+
+        segments.push_back({ from, (to - from) / segmentLength, segmentLength, length });
+        length += segmentLength;
+    }
+}
+
+Vector2 Path::PositionAt(float distance) const
+{
+    if (segments.empty())
+        return origin;
+
+    // Last segment starting at or before distance.
+    auto it = std::upper_bound(segments.begin(), segments.end(), distance,
+        [](float value, const PathSegment& segment) {
+            return value < segment.distance;
+        });
+    uint32_t segment = it == segments.begin() ? 0 : (uint32_t)(it - segments.begin() - 1);
+    return Advance(distance, segment);
+}
+
+Vector2 Path::Advance(float distance, uint32_t& segment) const
+{
+    if (segments.empty())
+        return origin;
+
+    while (segment + 1 < segments.size() && distance >= segments[segment + 1].distance)
+        segment++;
+
+    const PathSegment& current = segments[segment];
+    float along = Clamp(distance - current.distance, 0.0f, current.length);
+    return current.start + current.direction * along;
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include "Grid.h"
+
+#include <cstdint>
+#include <vector>
+
+// One straight piece of the enemy path between two consecutive waypoints.
+struct PathSegment
+{
+    Vector2 start;
+    Vector2 direction;      // Unit length.
+    float length;
+    float distance;         // Arc length from the start of the path to this segment's start.
+};
+
+// Waypoint list baked into a segment table, so a position along the path is one scalar.
+// Enemies store that distance and derive their position on demand: no per-tick normalize,
+// no overshooting waypoints at large dt, and distance doubles as a progress key for sorting.
+class Path
+{
+public:
+    Path() = default;
+    explicit Path(const std::vector<Cell>& waypoints);
+
+    // Position at the given arc length, clamped to the ends of the path.
+    Vector2 PositionAt(float distance) const;
+
+    // Same as PositionAt, but starts the segment search at `segment` and writes back where it ended.
+    // Enemies only move forward, so with a per-enemy hint this is O(1) amortized.
+    Vector2 Advance(float distance, uint32_t& segment) const;
+
+    float Length() const { return length; }
+    const std::vector<PathSegment>& Segments() const { return segments; }
+
+private:
+    std::vector<PathSegment> segments;
+    Vector2 origin{};
+    float length = 0.0f;
+};
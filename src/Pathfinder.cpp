@@ -0,0 +1,282 @@
+#include "Pathfinder.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+static const int INFINITE_COST = 0x3fffffff;
+static const uint64_t NOT_OPEN = UINT64_MAX;
+
+NavGrid::NavGrid(int rows, int cols, bool passable)
+    : rows(rows), cols(cols), passable((size_t)rows * cols, passable ? 1 : 0)
+{
+}
+
+NavGrid NavGridFromTiles(TileView tiles)
+{
+    NavGrid grid(tiles.Rows(), tiles.Cols());
+    for (int row = 0; row < tiles.Rows(); row++)
+    {
+        for (int col = 0; col < tiles.Cols(); col++)
+            grid.SetPassable({ row, col }, IsWalkable(tiles.Get(row, col)));
+    }
+    return grid;
+}
+
+static int Manhattan(Cell a, Cell b)
+{
+    return abs(a.row - b.row) + abs(a.col - b.col);
+}
+
+// Calls fn(neighbourIndex) for each in-bounds neighbour, in DIRECTIONS order.
+template<typename Fn>
+static void ForEachNeighbour(const NavGrid& grid, int index, Fn&& fn)
+{
+    Cell cell = grid.CellAt(index);
+    for (Cell dir : DIRECTIONS)
+    {
+        Cell adj = { cell.row + dir.row, cell.col + dir.col };
+        if (grid.Contains(adj))
+            fn(grid.Index(adj));
+    }
+}
+
+// Orders open-list entries so std::push_heap/pop_heap keep the smallest key on top.
+template<typename Entry>
+static bool HeapAfter(const Entry& a, const Entry& b)
+{
+    return a.key > b.key;
+}
+
+// -- A* ---------------------------------
+bool FindPathAStar(const NavGrid& grid, Cell start, Cell goal, std::vector<Cell>& route, size_t* expanded)
+{
+    struct Entry
+    {
+        uint64_t key;       // f in the high half, h in the low half: ties go to the cell nearer the goal.
+        int index;
+    };
+
+    route.clear();
+    if (expanded)
+        *expanded = 0;
+    if (!grid.Contains(start) || !grid.Contains(goal) || !grid.Passable(start) || !grid.Passable(goal))
+        return false;
+
+    size_t cellCount = (size_t)grid.Rows() * grid.Cols();
+    std::vector<int> cost(cellCount, INFINITE_COST);
+    std::vector<int> parent(cellCount, -1);
+    std::vector<uint8_t> closed(cellCount, 0);
+    std::vector<Entry> open;
+
+    auto push = [&](int index, int g) {
+        uint64_t h = (uint64_t)Manhattan(grid.CellAt(index), goal);
+        open.push_back({ ((g + h) << 32) | h, index });
+        std::push_heap(open.begin(), open.end(), HeapAfter<Entry>);
+    };
+
+    int startIndex = grid.Index(start);
+    int goalIndex = grid.Index(goal);
+    cost[startIndex] = 0;
+    push(startIndex, 0);
+    size_t expandedCount = 0;
+    while (!open.empty())
+    {
+        std::pop_heap(open.begin(), open.end(), HeapAfter<Entry>);
+        int index = open.back().index;
+        open.pop_back();
+        if (closed[index])
+            continue;
+        closed[index] = 1;
+        expandedCount++;
+        if (index == goalIndex)
+            break;
+
+        int next = cost[index] + 1;
+        ForEachNeighbour(grid, index, [&](int adj) {
+            if (grid.Passable(adj) && !closed[adj] && next < cost[adj])
+            {
+                cost[adj] = next;
+                parent[adj] = index;
+                push(adj, next);
+            }
+        });
+    }
+
+    if (expanded)
+        *expanded = expandedCount;
+    if (cost[goalIndex] == INFINITE_COST)
+        return false;
+
+    for (int index = goalIndex; index != -1; index = parent[index])
+        route.push_back(grid.CellAt(index));
+    std::reverse(route.begin(), route.end());
+    return true;
+}
+
+// -- D* LITE ---------------------------------
+DStarLite::DStarLite(NavGrid grid, Cell start, Cell goal)
+    : grid(std::move(grid)), start(start), goal(goal)
+{
+    size_t cellCount = (size_t)this->grid.Rows() * this->grid.Cols();
+    g.assign(cellCount, INFINITE_COST);
+    rhs.assign(cellCount, INFINITE_COST);
+    openKey.assign(cellCount, NOT_OPEN);
+    int goalIndex = this->grid.Index(goal);
+    rhs[goalIndex] = Lookahead(goalIndex);
+    UpdateVertex(goalIndex);
+}
+
+uint64_t DStarLite::Key(int index) const
+{
+    // (min(g, rhs) + h, min(g, rhs)) packed so one integer compare is the lexicographic compare.
+    uint64_t k2 = (uint64_t)std::min(g[index], rhs[index]);
+    uint64_t k1 = k2 + Manhattan(grid.CellAt(index), start);
+    return (k1 << 32) | k2;
+}
+
+int DStarLite::Lookahead(int index) const
+{
+    if (!grid.Passable(index))
+        return INFINITE_COST;
+    if (index == grid.Index(goal))
+        return 0;
+
+    int best = INFINITE_COST;
+    ForEachNeighbour(grid, index, [&](int adj) {
+        if (grid.Passable(adj) && g[adj] + 1 < best)
+            best = g[adj] + 1;
+    });
+    return best;
+}
+
+void DStarLite::UpdateVertex(int index)
+{
+    if (g[index] == rhs[index])
+    {
+        openKey[index] = NOT_OPEN;     // Any heap entry left behind is skipped when it surfaces.
+        return;
+    }
+
+    uint64_t key = Key(index);
+    if (openKey[index] != key)
+    {
+        openKey[index] = key;
+        open.push_back({ key, index });
+        std::push_heap(open.begin(), open.end(), HeapAfter<OpenEntry>);
+    }
+}
+
+void DStarLite::ComputeShortestPath()
+{
+    int startIndex = grid.Index(start);
+    int goalIndex = grid.Index(goal);
+    while (true)
+    {
+        while (!open.empty() && open.front().key != openKey[open.front().index])
+        {
+            std::pop_heap(open.begin(), open.end(), HeapAfter<OpenEntry>);
+            open.pop_back();
+        }
+        if (open.empty() || (open.front().key >= Key(startIndex) && g[startIndex] == rhs[startIndex]))
+            break;
+
+        int index = open.front().index;
+        std::pop_heap(open.begin(), open.end(), HeapAfter<OpenEntry>);
+        open.pop_back();
+        openKey[index] = NOT_OPEN;
+        expanded++;
+
+        if (g[index] > rhs[index])
+        {
+            // Overconsistent: the distance got shorter. Settle it; neighbours can only improve through it.
+            g[index] = rhs[index];
+            ForEachNeighbour(grid, index, [&](int adj) {
+                if (adj != goalIndex && grid.Passable(adj) && g[index] + 1 < rhs[adj])
+                {
+                    rhs[adj] = g[index] + 1;
+                    UpdateVertex(adj);
+                }
+            });
+        }
+        else
+        {
+            // Underconsistent: the old distance is no longer achievable. Forget it and re-derive this
+            // cell and every neighbour whose lookahead went through it.
+            int oldCost = g[index];
+            g[index] = INFINITE_COST;
+            rhs[index] = Lookahead(index);
+            UpdateVertex(index);
+            ForEachNeighbour(grid, index, [&](int adj) {
+                if (adj != goalIndex && rhs[adj] == oldCost + 1)
+                {
+                    rhs[adj] = Lookahead(adj);
+                    UpdateVertex(adj);
+                }
+            });
+        }
+    }
+}
+
+void DStarLite::SetPassable(Cell cell, bool passable)
+{
+    if (!grid.Contains(cell) || grid.Passable(cell) == passable)
+        return;
+
+    // Every edge touching the cell changed cost, so re-derive the cell and its neighbours.
+    grid.SetPassable(cell, passable);
+    int index = grid.Index(cell);
+    rhs[index] = Lookahead(index);
+    UpdateVertex(index);
+    ForEachNeighbour(grid, index, [this](int adj) {
+        rhs[adj] = Lookahead(adj);
+        UpdateVertex(adj);
+    });
+}
+
+bool DStarLite::Plan(std::vector<Cell>& route)
+{
+    expanded = 0;
+    route.clear();
+    if (!grid.Contains(start) || !grid.Contains(goal))
+        return false;
+
+    ComputeShortestPath();
+    int index = grid.Index(start);
+    if (g[index] >= INFINITE_COST)
+        return false;
+
+    // Walk downhill: each step goes to the neighbour with the smallest distance (first in DIRECTIONS on ties).
+    int goalIndex = grid.Index(goal);
+    route.push_back(start);
+    while (index != goalIndex)
+    {
+        int next = -1;
+        ForEachNeighbour(grid, index, [&](int adj) {
+            if (grid.Passable(adj) && (next < 0 || g[adj] < g[next]))
+                next = adj;
+        });
+        if (next < 0 || g[next] >= g[index] || route.size() > g.size())
+        {
+            route.clear();
+            return false;
+        }
+        index = next;
+        route.push_back(grid.CellAt(index));
+    }
+    return true;
+}
+
+std::vector<Cell> RouteWaypoints(const std::vector<Cell>& route)
+{
+    std::vector<Cell> waypoints;
+    for (size_t i = 0; i < route.size(); i++)
+    {
+        bool end = i == 0 || i + 1 == route.size();
+        bool turn = !end &&
+            (route[i].row - route[i - 1].row != route[i + 1].row - route[i].row ||
+             route[i].col - route[i - 1].col != route[i + 1].col - route[i].col);
+        if (end || turn)
+            waypoints.push_back(route[i]);
+    }
+    return waypoints;
+}
@@ -0,0 +1,90 @@
+#pragma once
+#include "Grid.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Four-connected grid of walkable cells, any size. Every step between two walkable cells costs 1.
+class NavGrid
+{
+public:
+    NavGrid() = default;
+    NavGrid(int rows, int cols, bool passable = false);
+
+    int Rows() const { return rows; }
+    int Cols() const { return cols; }
+    int Index(Cell cell) const { return cell.row * cols + cell.col; }
+    Cell CellAt(int index) const { return { index / cols, index % cols }; }
+
+    bool Contains(Cell cell) const { return InBounds(cell, rows, cols); }
+    bool Passable(Cell cell) const { return passable[Index(cell)] != 0; }
+    bool Passable(int index) const { return passable[index] != 0; }
+    void SetPassable(Cell cell, bool value) { passable[Index(cell)] = value ? 1 : 0; }
+
+private:
+    int rows = 0;
+    int cols = 0;
+    std::vector<uint8_t> passable;
+};
+
+// Enemies walk on the dirt road and its waypoints; grass, turrets and rock block them.
+inline bool IsWalkable(int tile)
+{
+    return tile == DIRT || tile == WAYPOINT;
+}
+
+NavGrid NavGridFromTiles(TileView tiles);
+
+// One-shot A* with a Manhattan heuristic. Writes the cells from start to goal inclusive into route
+// and returns true, or clears route and returns false if the goal can't be reached.
+// If expanded is given it receives the number of cells taken off the open list.
+bool FindPathAStar(const NavGrid& grid, Cell start, Cell goal, std::vector<Cell>& route, size_t* expanded = nullptr);
+
+// Incremental planner (D* Lite, Koenig & Likhachev 2002). Distances are searched backwards from
+// the goal and kept between plans, so after a few SetPassable calls the next Plan only re-expands
+// the cells whose distance to the goal actually changed instead of searching the whole map again.
+// The start is fixed (enemies always enter at the spawn), so keys never need the km correction.
+class DStarLite
+{
+public:
+    DStarLite() = default;
+    DStarLite(NavGrid grid, Cell start, Cell goal);
+
+    // Opens or blocks one cell. Cheap: the repair happens in the next Plan.
+    void SetPassable(Cell cell, bool passable);
+
+    // Brings distances up to date and writes the route like FindPathAStar.
+    bool Plan(std::vector<Cell>& route);
+
+    const NavGrid& Grid() const { return grid; }
+    Cell Start() const { return start; }
+    Cell Goal() const { return goal; }
+
+    // Cells taken off the open list by the last Plan.
+    size_t Expanded() const { return expanded; }
+
+private:
+    struct OpenEntry
+    {
+        uint64_t key;
+        int index;
+    };
+
+    uint64_t Key(int index) const;
+    int Lookahead(int index) const;     // rhs: one step plus the best neighbour's distance.
+    void UpdateVertex(int index);       // Puts the cell on the open list iff g != rhs.
+    void ComputeShortestPath();
+
+    NavGrid grid;
+    Cell start{};
+    Cell goal{};
+    std::vector<int> g;                 // Distance to the goal as of the last expansion.
+    std::vector<int> rhs;               // One-step lookahead distance; the cell is settled when g == rhs.
+    std::vector<uint64_t> openKey;      // Key of the cell's live open-list entry, NOT_OPEN if none.
+    std::vector<OpenEntry> open;        // Binary min-heap; entries not matching openKey are stale.
+    size_t expanded = 0;
+};
+
+// Reduces a route to its turning points (plus both ends), the form Path takes.
+std::vector<Cell> RouteWaypoints(const std::vector<Cell>& route);
@@ -0,0 +1,120 @@
+#include "Profiler.h"
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define PROFILER_RDTSC
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define PROFILER_RDTSC
+#endif
+
+// Events kept per thread before the oldest are overwritten (24 bytes each).
+static const size_t RING_CAPACITY = 1 << 16;
+
+uint64_t ProfilerNow()
+{
+#if defined(PROFILER_RDTSC)
+    return __rdtsc();
+#else
+    return (uint64_t)std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+}
+
+double ProfilerTicksPerMicrosecond()
+{
+    static const double ticksPerMicrosecond = []() {
+#if defined(PROFILER_RDTSC)
+        // Calibrate the TSC against steady_clock over a short busy wait.
+        auto start = std::chrono::steady_clock::now();
+        uint64_t startTicks = __rdtsc();
+        while (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(20))
+        {
+        }
+        uint64_t endTicks = __rdtsc();
+        double microseconds = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        return (endTicks - startTicks) / microseconds;
+#else
+        using Period = std::chrono::steady_clock::period;
+        return (double)Period::den / Period::num / 1e6;
+#endif
+    }();
+    return ticksPerMicrosecond;
+}
+
+ProfileRing::ProfileRing(size_t capacity, uint32_t threadId)
+    : events(capacity), threadId(threadId)
+{
+}
+
+void ProfileRing::CopyTo(std::vector<ProfileEvent>& out) const
+{
+    size_t first = (next + events.size() - count) % events.size();
+    for (size_t i = 0; i < count; i++)
+        out.push_back(events[(first + i) % events.size()]);
+}
+
+namespace
+{
+    std::mutex registryMutex;
+    std::vector<std::unique_ptr<ProfileRing>> registry;
+}
+
+ProfileRing& Profiler::ThreadRing()
+{
+    thread_local ProfileRing* ring = nullptr;
+    if (!ring)
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        registry.push_back(std::make_unique<ProfileRing>(RING_CAPACITY, (uint32_t)registry.size()));
+        ring = registry.back().get();
+    }
+    return *ring;
+}
+
+bool Profiler::ExportChromeTrace(const char* path)
+{
+    FILE* file = fopen(path, "w");
+    if (!file)
+        return false;
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+    std::vector<std::vector<ProfileEvent>> perThread(registry.size());
+    uint64_t origin = UINT64_MAX;
+    for (size_t t = 0; t < registry.size(); t++)
+    {
+        registry[t]->CopyTo(perThread[t]);
+        for (const ProfileEvent& event : perThread[t])
+            origin = event.begin < origin ? event.begin : origin;
+    }
+
+    // Complete ("X") events with microsecond timestamps relative to the first recorded event.
+    double ticksPerMicrosecond = ProfilerTicksPerMicrosecond();
+    bool first = true;
+    fprintf(file, "{\"traceEvents\":[");
+    for (size_t t = 0; t < registry.size(); t++)
+    {
+        for (const ProfileEvent& event : perThread[t])
+        {
+            fprintf(file, "%s\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                first ? "" : ",", event.name, registry[t]->ThreadId(),
+                (event.begin - origin) / ticksPerMicrosecond, (event.end - event.begin) / ticksPerMicrosecond);
+            first = false;
+        }
+    }
+    fprintf(file, "\n],\"displayTimeUnit\":\"ns\"}\n");
+    fclose(file);
+    return true;
+}
+
+void Profiler::Clear()
+{
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (std::unique_ptr<ProfileRing>& ring : registry)
+        ring->Clear();
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Scoped phase timers recorded into a preallocated ring buffer per thread, exported as Chrome
+// trace JSON (load it in chrome://tracing or ui.perfetto.dev).
+//
+// Timers are compiled out entirely unless PROFILER_ENABLED is 1. Define it for the whole project
+// (e.g. PROFILER_ENABLED=1 in the preprocessor definitions) so every file agrees.
+#ifndef PROFILER_ENABLED
+#define PROFILER_ENABLED 0
+#endif
+
+struct ProfileEvent
+{
+    const char* name;       // Must be a string literal or otherwise outlive the profiler.
+    uint64_t begin;         // Ticks from ProfilerNow.
+    uint64_t end;
+};
+
+// Timestamp in ticks: rdtsc on x86, steady_clock elsewhere.
+uint64_t ProfilerNow();
+
+// Ticks per microsecond, measured once against steady_clock on first use.
+double ProfilerTicksPerMicrosecond();
+
+// Fixed-capacity event ring for one thread. When full, the oldest events are overwritten.
+class ProfileRing
+{
+public:
+    explicit ProfileRing(size_t capacity, uint32_t threadId);
+
+    void Record(const char* name, uint64_t begin, uint64_t end)
+    {
+        events[next] = { name, begin, end };
+        next = next + 1 == events.size() ? 0 : next + 1;
+        if (count < events.size())
+            count++;
+    }
+
+    // Events oldest first.
+    void CopyTo(std::vector<ProfileEvent>& out) const;
+    void Clear() { next = count = 0; }
+    uint32_t ThreadId() const { return threadId; }
+
+private:
+    std::vector<ProfileEvent> events;
+    size_t next = 0;
+    size_t count = 0;
+    uint32_t threadId;
+};
+
+namespace Profiler
+{
+    // Ring for the calling thread, created (and registered for export) on first use.
+    ProfileRing& ThreadRing();
+
+    // Writes every thread's events to a Chrome trace JSON file. Returns false if the file can't be opened.
+    bool ExportChromeTrace(const char* path);
+
+    // Drops all recorded events on every thread.
+    void Clear();
+}
+
+// Records the time between construction and destruction under `name`.
+class ProfileScope
+{
+public:
+    explicit ProfileScope(const char* name) : name(name), begin(ProfilerNow()) {}
+    ~ProfileScope()
+    {
+        uint64_t end = ProfilerNow();
+        Profiler::ThreadRing().Record(name, begin, end);
+    }
+
+private:
+    const char* name;
+    uint64_t begin;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#if PROFILER_ENABLED
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name)
+#else
+#define PROFILE_SCOPE(name) ((void)0)
+#endif
@@ -0,0 +1,200 @@
+#include "Render.h"
+#include "Simulation.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+bool RenderCommand::operator==(const RenderCommand& other) const
+{
+    return type == other.type && color == other.color && fontSize == other.fontSize &&
+        x == other.x && y == other.y && width == other.width && height == other.height;
+}
+
+void RenderList::Reset()
+{
+    commands.clear();
+    texts.clear();
+}
+
+void RenderList::Clear(RenderColor color)
+{
+    commands.push_back({ RENDER_CLEAR, color, 0, 0, 0.0f, 0.0f, 0.0f, 0.0f });
+}
+
+void RenderList::Rectangle(float x, float y, float width, float height, RenderColor color)
+{
+    commands.push_back({ RENDER_RECTANGLE, color, 0, 0, x, y, width, height });
+}
+
+void RenderList::Circle(Vector2 center, float radius, RenderColor color)
+{
+    commands.push_back({ RENDER_CIRCLE, color, 0, 0, center.x, center.y, radius, 0.0f });
+}
+
+void RenderList::Text(const char* text, float x, float y, int fontSize, RenderColor color)
+{
+    uint32_t offset = (uint32_t)texts.size();
+    texts.insert(texts.end(), text, text + strlen(text) + 1);
+    commands.push_back({ RENDER_TEXT, color, (int16_t)fontSize, offset, x, y, 0.0f, 0.0f });
+}
+
+static void DrawTile(RenderList& list, int row, int col, RenderColor color)
+{
+    Vector2 corner = TileCorner(row, col);
+    list.Rectangle(corner.x, corner.y, TILE_SIZE, TILE_SIZE, color);
+}
+
+static RenderColor TileColor(int type)
+{
+    return type == ROCK ? COLOR_GRAY : type > 0 ? COLOR_BEIGE : COLOR_GREEN;
+}
+
+void TileLayerCache::Update(const ChunkedTileMap& tiles)
+{
+    rebuilt = 0;
+    if (&tiles != source || tiles.Rows() != sourceRows || tiles.Cols() != sourceCols || tiles.Version() < seen)
+    {
+        source = &tiles;
+        sourceRows = tiles.Rows();
+        sourceCols = tiles.Cols();
+        chunks.assign(tiles.ChunkCount(), {});
+        changed.clear();
+        for (int chunk = 0; chunk < tiles.ChunkCount(); chunk++)
+            changed.push_back(chunk);
+    }
+    else
+    {
+        tiles.ChangedSince(seen, changed);
+    }
+
+    for (int chunk : changed)
+        BuildChunk(tiles, chunk);
+    rebuilt = changed.size();
+    seen = tiles.Version();
+}
+
+void TileLayerCache::BuildChunk(const ChunkedTileMap& tiles, int chunk)
+{
+    std::vector<TileRect>& rects = chunks[chunk];
+    rects.clear();
+    open.clear();
+    uint8_t types[CHUNK_TILES];
+    tiles.DecodeChunk(chunk, types);
+    ChunkRect bounds = tiles.ChunkBounds(chunk);
+    for (int row = 0; row < bounds.rows; row++)
+    {
+        next.clear();
+        size_t above = 0;
+        const uint8_t* line = types + row * CHUNK_SIZE;
+        for (int col = 0; col < bounds.cols;)
+        {
+            RenderColor color = TileColor(line[col]);
+            int runEnd = col + 1;
+            while (runEnd < bounds.cols && TileColor(line[runEnd]) == color)
+                runEnd++;
+
+            // Grow the rectangle from the row above if it covers exactly this run.
+            int rectCol = bounds.col + col;
+            while (above < open.size() && rects[open[above]].col < rectCol)
+                above++;
+            if (above < open.size() && rects[open[above]].col == rectCol && rects[open[above]].cols == runEnd - col &&
+                rects[open[above]].color == color)
+            {
+                rects[open[above]].rows++;
+                next.push_back(open[above]);
+            }
+            else
+            {
+                rects.push_back({ bounds.row + row, rectCol, 1, runEnd - col, color });
+                next.push_back((int)rects.size() - 1);
+            }
+            col = runEnd;
+        }
+        open.swap(next);
+    }
+}
+
+void TileLayerCache::Emit(RenderList& list, int rows, int cols) const
+{
+    if (!source)
+        return;
+    int chunkRows = std::min(source->ChunksDown(), (rows + CHUNK_SIZE - 1) >> CHUNK_SHIFT);
+    int chunkCols = std::min(source->ChunksAcross(), (cols + CHUNK_SIZE - 1) >> CHUNK_SHIFT);
+    for (int chunkRow = 0; chunkRow < chunkRows; chunkRow++)
+    {
+        for (int chunkCol = 0; chunkCol < chunkCols; chunkCol++)
+        {
+            for (const TileRect& rect : chunks[chunkRow * source->ChunksAcross() + chunkCol])
+            {
+                Vector2 corner = TileCorner(rect.row, rect.col);
+                list.Rectangle(corner.x, corner.y, rect.cols * TILE_SIZE, rect.rows * TILE_SIZE, rect.color);
+            }
+        }
+    }
+}
+
+void BuildFrame(const Simulation& simulation, Cell mouseCell, TileLayerCache& tileLayer, RenderList& list)
+{
+    const SimulationConfig& config = simulation.Config();
+    list.Reset();
+    list.Clear(COLOR_BLACK);
+
+    // Only the chunks that reach the screen; larger maps are cut off at the window edge.
+    const ChunkedTileMap& tiles = simulation.Tiles();
+    int visible = (int)std::ceil(SCREEN_SIZE / TILE_SIZE);
+    tileLayer.Update(tiles);
+    tileLayer.Emit(list, visible, visible);
+
+    const EnemyStore& enemies = simulation.Enemies();
+    for (size_t i = 0; i < enemies.size(); i++)                 // [HW3] Draw enemies when spawned from vector.
+        list.Circle(enemies.Position(i), config.enemyRadius, COLOR_RED);
+
+    for (const Turret& turret : simulation.Turrets())           // [HW3] Draw turrets, not simple to change them to squares so they're staying as circles.
+        list.Circle(turret.position, config.enemyRadius, COLOR_DARKPURPLE);
+
+    const BulletStore& bullets = simulation.Bullets();
+    for (size_t i = 0; i < bullets.size(); i++)
+        list.Circle(bullets.Position(i), config.bulletRadius, COLOR_BLUE);
+
+    char text[64];
+    snprintf(text, sizeof(text), "Total bullets: %i", (int)bullets.size());
+    list.Text(text, 10, 10, 20, COLOR_BLUE);
+
+    // A tile that can't be built on without cutting the route is shown red instead.
+    bool blocked = tiles.Contains(mouseCell) && simulation.WouldBlockRoute(mouseCell);
+    DrawTile(list, mouseCell.row, mouseCell.col, blocked ? COLOR_RED : COLOR_SKYBLUE);    // [A1] Draw mouse position tile with sky blue colour.
+}
+
+void RecordingBackend::Submit(const RenderList& list)
+{
+    lastFrame = list;
+    frameCount++;
+    drawCalls = 0;
+    for (size_t& count : counts)
+        count = 0;
+    for (const RenderCommand& command : list.Commands())
+    {
+        counts[command.type]++;
+        if (command.type != RENDER_CLEAR)
+            drawCalls++;
+    }
+}
+
+size_t DiffFrames(const RenderList& a, const RenderList& b)
+{
+    const std::vector<RenderCommand>& lhs = a.Commands();
+    const std::vector<RenderCommand>& rhs = b.Commands();
+    size_t shared = lhs.size() < rhs.size() ? lhs.size() : rhs.size();
+    size_t different = (lhs.size() > rhs.size() ? lhs.size() : rhs.size()) - shared;
+    for (size_t i = 0; i < shared; i++)
+    {
+        bool same = lhs[i] == rhs[i];
+        if (same && lhs[i].type == RENDER_TEXT)
+            same = strcmp(a.TextOf(lhs[i]), b.TextOf(rhs[i])) == 0;
+        if (!same)
+            different++;
+    }
+    return different;
+}
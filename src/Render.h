@@ -0,0 +1,137 @@
+#pragma once
+#include "Grid.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class Simulation;
+class ChunkedTileMap;
+
+// Same layout as raylib's Color, declared here so command lists build without raylib.
+struct RenderColor
+{
+    uint8_t r;
+    uint8_t g;
+    uint8_t b;
+    uint8_t a;
+
+    bool operator==(const RenderColor& other) const { return r == other.r && g == other.g && b == other.b && a == other.a; }
+    bool operator!=(const RenderColor& other) const { return !(*this == other); }
+};
+
+// raylib palette entries used by the game.
+const RenderColor COLOR_BLACK{ 0, 0, 0, 255 };
+const RenderColor COLOR_GREEN{ 0, 228, 48, 255 };
+const RenderColor COLOR_BEIGE{ 211, 176, 131, 255 };
+const RenderColor COLOR_RED{ 230, 41, 55, 255 };
+const RenderColor COLOR_DARKPURPLE{ 112, 31, 126, 255 };
+const RenderColor COLOR_BLUE{ 0, 121, 241, 255 };
+const RenderColor COLOR_SKYBLUE{ 102, 191, 255, 255 };
+const RenderColor COLOR_GRAY{ 130, 130, 130, 255 };
+
+enum RenderCommandType : uint8_t
+{
+    RENDER_CLEAR,
+    RENDER_RECTANGLE,   // x, y, width, height
+    RENDER_CIRCLE,      // x, y = center, width = radius
+    RENDER_TEXT,        // x, y, fontSize; text is an offset into the list's text arena
+    RENDER_COMMAND_COUNT
+};
+
+struct RenderCommand
+{
+    RenderCommandType type;
+    RenderColor color;
+    int16_t fontSize;
+    uint32_t text;
+    float x;
+    float y;
+    float width;
+    float height;
+
+    bool operator==(const RenderCommand& other) const;
+    bool operator!=(const RenderCommand& other) const { return !(*this == other); }
+};
+
+// Flat list of draw commands for one frame. Building it makes no raylib calls, so a frame can be
+// produced, measured and compared on a machine without a GPU, then submitted to any backend.
+class RenderList
+{
+public:
+    void Reset();
+
+    void Clear(RenderColor color);
+    void Rectangle(float x, float y, float width, float height, RenderColor color);
+    void Circle(Vector2 center, float radius, RenderColor color);
+    void Text(const char* text, float x, float y, int fontSize, RenderColor color);
+
+    const std::vector<RenderCommand>& Commands() const { return commands; }
+    const char* TextOf(const RenderCommand& command) const { return texts.data() + command.text; }
+
+private:
+    std::vector<RenderCommand> commands;
+    std::vector<char> texts;            // Null-terminated strings back to back.
+};
+
+// The tile layer as rectangles, kept per map chunk. Runs of same-coloured tiles in a row are merged,
+// and so are identical runs in the rows below, so open ground costs a rectangle or two per chunk
+// instead of one per tile. Update rebuilds only the chunks edited since the previous call.
+class TileLayerCache
+{
+public:
+    void Update(const ChunkedTileMap& tiles);
+
+    // Emits the rectangles of every chunk overlapping the first rows x cols tiles.
+    void Emit(RenderList& list, int rows, int cols) const;
+
+    size_t RebuiltChunks() const { return rebuilt; }     // By the last Update.
+
+private:
+    struct TileRect
+    {
+        int row;
+        int col;
+        int rows;
+        int cols;
+        RenderColor color;
+    };
+
+    void BuildChunk(const ChunkedTileMap& tiles, int chunk);
+
+    const ChunkedTileMap* source = nullptr;
+    int sourceRows = 0;
+    int sourceCols = 0;
+    uint64_t seen = 0;
+    size_t rebuilt = 0;
+    std::vector<std::vector<TileRect>> chunks;
+    std::vector<int> changed;
+    std::vector<int> open;              // BuildChunk scratch: rects still growing down, by column.
+    std::vector<int> next;
+};
+
+// Emits the whole game frame: tiles, enemies, turrets, bullets, HUD text and the hovered tile.
+// The tile layer comes from tileLayer, which is brought up to date first.
+void BuildFrame(const Simulation& simulation, Cell mouseCell, TileLayerCache& tileLayer, RenderList& list);
+
+// Headless backend: keeps the last submitted frame and counts draw calls, no GL required.
+class RecordingBackend
+{
+public:
+    void Submit(const RenderList& list);
+
+    const RenderList& LastFrame() const { return lastFrame; }
+    size_t FrameCount() const { return frameCount; }
+    size_t DrawCalls() const { return drawCalls; }                    // Last frame, every command except clears.
+    size_t CountOf(RenderCommandType type) const { return counts[type]; }   // Last frame.
+
+private:
+    RenderList lastFrame;
+    size_t frameCount = 0;
+    size_t drawCalls = 0;
+    size_t counts[RENDER_COMMAND_COUNT]{};
+};
+
+// Number of command slots that differ between two frames, counting extra commands in the longer one.
+size_t DiffFrames(const RenderList& a, const RenderList& b);
@@ -0,0 +1,466 @@
+#include "Simulation.h"
+
+#include "Kernels.h"
+#include "Profiler.h"
+
+#include <algorithm>
+#include <utility>
+
+// Broadphase layers. Pairs come out as (bullet, enemy).
+static const int BULLET_LAYER = 0;
+static const int ENEMY_LAYER = 1;
+
+// Items per ParallelFor chunk for each phase. Chunking depends only on these, never on the thread count.
+static const size_t TURRET_GRAIN = 64;
+static const size_t BULLET_GRAIN = 16384;
+static const size_t PAIR_GRAIN = 4096;
+
+// Makes sure there is one (cleared) output buffer per chunk.
+template<typename T>
+static void PrepareBuffers(std::vector<std::vector<T>>& buffers, size_t chunkCount)
+{
+    if (buffers.size() < chunkCount)
+        buffers.resize(chunkCount);
+    for (size_t chunk = 0; chunk < chunkCount; chunk++)
+        buffers[chunk].clear();
+}
+
+// Same test as raylib's CheckCollisionCircles, kept here so the update path has no raylib calls.
+static bool CirclesOverlap(Vector2 center1, float radius1, Vector2 center2, float radius2)
+{
+    float radii = radius1 + radius2;
+    return DistanceSqr(center1, center2) <= radii * radii;
+}
+
+Simulation::Simulation(TileView tiles, Cell spawn, Cell goal, SimulationConfig config)
+    : tiles(tiles), config(config), planner(NavGridFromTiles(tiles), spawn, goal), connectivity(planner.Grid(), spawn, goal), enemyGrid(config.targetingCellSize),
+      jobs(new JobSystem(config.threadCount))
+{
+    planner.Plan(route);
+    RebuildPath();
+
+    for (int row = 0; row < this->tiles.Rows(); ++row)      // [HW3] for each row...
+    {
+        for (int col = 0; col < this->tiles.Cols(); ++col)  // [HW3] and for each column...
+        {
+            if (this->tiles.Get(row, col) == TURRET)        // [HW3] If the tile is equal to 3...
+            {
+                Turret turret;                              // [HW3] Apply struct data to turret variable.
+                turret.position = TileCenter(row, col);     // [HW3] Place turret in the center of pre-determined tile position.
+                turrets.push_back(turret);                  // [HW3] Creates a space and adds turret value to the end of the vector.
+            }
+        }
+    }
+    for (Turret& turret : turrets)
+        BuildSight(turret);
+}
+
+const char* PhaseName(SimulationPhase phase)
+{
+    static const char* names[PHASE_COUNT] = {
+        "spawning", "pathFollowing", "targeting", "bulletMovement", "collision", "removal"
+    };
+    return phase < PHASE_COUNT ? names[phase] : "unknown";
+}
+
+void Simulation::Step(float dt)
+{
+    PROFILE_SCOPE("Step");
+    uint64_t stamps[PHASE_COUNT + 1];
+    stamps[PHASE_SPAWNING] = ProfilerNow();
+    SpawnEnemies(dt);
+    stamps[PHASE_PATH_FOLLOWING] = ProfilerNow();
+    MoveEnemies(dt);
+    stamps[PHASE_TARGETING] = ProfilerNow();
+    UpdateTurrets(dt);
+    stamps[PHASE_BULLET_MOVEMENT] = ProfilerNow();
+    MoveBullets(dt);
+    stamps[PHASE_COLLISION] = ProfilerNow();
+    CollideBullets();
+    stamps[PHASE_REMOVAL] = ProfilerNow();
+    RemoveDead();
+    stamps[PHASE_COUNT] = ProfilerNow();
+
+    for (int phase = 0; phase < PHASE_COUNT; phase++)
+        phaseTicks[phase] += stamps[phase + 1] - stamps[phase];
+    tickCount++;
+}
+
+bool Simulation::SetTile(Cell cell, TileType type)
+{
+    if (!tiles.Contains(cell) || tiles.Get(cell) == type)
+        return false;
+
+    int previous = tiles.Get(cell);
+    if (IsWalkable(previous) != IsWalkable(type))
+    {
+        // Opening a cell can't cut the route, and the connectivity check rules out blocking one that would.
+        if (WouldBlockRoute(cell))
+            return false;
+        connectivity.SetPassable(cell, IsWalkable(type));
+        planner.SetPassable(cell, IsWalkable(type));
+        planner.Plan(route);
+        RebuildPath();
+    }
+
+    tiles.Set(cell, type);
+
+    // Only turrets whose sight square holds the tile can see differently, and only if it starts or
+    // stops blocking sight.
+    if (BlocksSight(previous) != BlocksSight(type))
+    {
+        for (Turret& turret : turrets)
+        {
+            if (turret.sight.Covers(cell))
+                BuildSight(turret);
+        }
+    }
+
+    Vector2 center = TileCenter(cell.row, cell.col);
+    if (previous == TURRET)
+    {
+        turrets.erase(std::remove_if(turrets.begin(), turrets.end(), [center](const Turret& turret) {
+            return turret.position.x == center.x && turret.position.y == center.y;
+        }), turrets.end());
+    }
+    if (type == TURRET)
+        AddTurret(center);
+    return true;
+}
+
+void Simulation::RebuildPath()
+{
+    waypoints = RouteWaypoints(route);
+    path = Path(waypoints);
+    if (config.flowFieldSteering)
+    {
+        // Only SteerEnemies reads the field, so path mode never pays for the BFS.
+        flow.Build(planner.Grid(), planner.Goal(), jobs.get());
+        return;
+    }
+
+    // Segment hints index the old table; restart them and re-derive positions on the new route.
+    for (size_t i = 0; i < enemies.size(); i++)
+    {
+        enemies.segment[i] = 0;
+        enemies.distance[i] = std::min(enemies.distance[i], path.Length());
+        Vector2 position = path.Advance(enemies.distance[i], enemies.segment[i]);
+        enemies.x[i] = position.x;
+        enemies.y[i] = position.y;
+    }
+}
+
+Handle Simulation::SpawnEnemy(float distance)
+{
+    Enemy enemy;
+    enemy.distance = Clamp(distance, 0.0f, path.Length());
+    enemy.position = path.PositionAt(enemy.distance);
+    enemy.atEnd = enemy.distance >= path.Length();
+    return enemies.Insert(enemy);
+}
+
+void Simulation::AddTurret(Vector2 position)
+{
+    Turret turret;
+    turret.position = position;
+    BuildSight(turret);
+    turrets.push_back(std::move(turret));
+}
+
+void Simulation::BuildSight(Turret& turret)
+{
+    turret.sight.Build(tiles, TileAt(turret.position), SightRadius(turret.range));
+}
+
+Handle Simulation::SpawnBullet(const Bullet& bullet)
+{
+    return bullets.Insert(bullet);
+}
+
+double Simulation::PhaseNanoseconds(SimulationPhase phase) const
+{
+    return phaseTicks[phase] * 1000.0 / ProfilerTicksPerMicrosecond();
+}
+
+void Simulation::ResetPhaseTimes()
+{
+    for (uint64_t& ticks : phaseTicks)
+        ticks = 0;
+}
+
+template<typename T>
+static size_t Bytes(const std::vector<T>& values)
+{
+    return values.capacity() * sizeof(T);
+}
+
+size_t Simulation::MemoryBytes() const
+{
+    size_t bytes = Bytes(enemies.distance) + Bytes(enemies.segment) + Bytes(enemies.x) + Bytes(enemies.y) +
+        Bytes(enemies.health) + Bytes(enemies.atEnd);
+    bytes += Bytes(bullets.x) + Bytes(bullets.y) + Bytes(bullets.dirX) + Bytes(bullets.dirY) +
+        Bytes(bullets.time) + Bytes(bullets.enabled);
+    bytes += enemies.index.MemoryBytes() + bullets.index.MemoryBytes();
+    bytes += Bytes(turrets) + Bytes(pairs) + Bytes(remap) + Bytes(origin);
+    for (const Turret& turret : turrets)
+        bytes += turret.sight.MemoryBytes();
+    bytes += broadphase.MemoryBytes() + enemyGrid.MemoryBytes() + flow.MemoryBytes();
+    for (const std::vector<Bullet>& buffer : spawnBuffers)
+        bytes += Bytes(buffer);
+    for (const std::vector<uint32_t>& buffer : hitBuffers)
+        bytes += Bytes(buffer);
+    return bytes;
+}
+
+void Simulation::SpawnEnemies(float dt)
+{
+    PROFILE_SCOPE("Spawning");
+    enemyCDT += dt;     // [HW3] Enemy spawn cool down
+
+    if (enemyCDT >= config.spawnStall && enemySpawned < config.enemyTotal)  // [HW3] If enemy cool down is greater or equal to spawn stall time (1 second)
+    {                                                                       // and total spawned enemies is less then or equal to total enemies (10 units)...
+        Enemy enemy;                                            // [HW3] Create enemy from struct,
+        enemySpawned++;                                         // [HW3] Adds 1 to total enemy variable,
+        enemy.position = path.PositionAt(enemy.distance);       // [HW3] Set spawn position at the start of the path,
+        enemies.Insert(enemy);                                  // [HW3] Places enemy at end of vector,
+        enemyCDT = 0.0f;                                        // [HW3] Reset cool down.
+    }
+}
+
+void Simulation::MoveEnemies(float dt)
+{
+    PROFILE_SCOPE("PathFollowing");
+    if (config.flowFieldSteering)
+    {
+        SteerEnemies(dt);
+        return;
+    }
+
+    // Progress is a scalar, so the move is exact for any dt: advance every distance in one kernel,
+    // then derive positions from the segment table.
+    float length = path.Length();
+    AddKernel(enemies.distance.data(), config.enemySpeed * dt, enemies.size());
+
+    for (size_t i = 0; i < enemies.size(); i++)        // [HW3]  For each enemy in enemies vector...
+    {
+        if (enemies.distance[i] >= length)              // [HW3] If an enemy has reached the end...
+        {
+            enemies.distance[i] = length;
+            enemies.atEnd[i] = true;
+        }
+
+        Vector2 position = path.Advance(enemies.distance[i], enemies.segment[i]);
+        enemies.x[i] = position.x;
+        enemies.y[i] = position.y;
+    }
+}
+
+void Simulation::SteerEnemies(float dt)
+{
+    // Each enemy heads for the centre of the cell downhill from its own: one lookup per cell crossed,
+    // whatever the map size or the number of spawns. Reaching a centre carries the rest of the step
+    // on to the next one, so enemies cover enemySpeed * dt per tick for any dt, as on the path.
+    // Distance still accumulates as the targeting progress key.
+    float step = config.enemySpeed * dt;
+    for (size_t i = 0; i < enemies.size(); i++)
+    {
+        Vector2 position = enemies.Position(i);
+        Cell cell = { (int)(position.y / TILE_SIZE), (int)(position.x / TILE_SIZE) };
+        float left = step;
+        while (left > 0.0f && !enemies.atEnd[i])
+        {
+            if (!tiles.Contains(cell) || flow.Distance(cell) == FlowField::UNREACHABLE)
+                break;      // Walled off until an edit opens a way.
+
+            Cell next = flow.Next(cell);
+            Vector2 target = TileCenter(next.row, next.col);
+            Vector2 toTarget = target - position;
+            float remaining = Length(toTarget);
+            if (remaining <= left)
+            {
+                position = target;
+                cell = next;
+                left -= remaining;
+                enemies.distance[i] += remaining;
+                enemies.atEnd[i] = flow.Distance(next) == 0;
+            }
+            else
+            {
+                position = position + toTarget * (left / remaining);
+                enemies.distance[i] += left;
+                left = 0.0f;
+            }
+        }
+
+        enemies.x[i] = position.x;
+        enemies.y[i] = position.y;
+    }
+}
+
+void Simulation::UpdateTurrets(float dt)
+{
+    PROFILE_SCOPE("Targeting");
+    // The grid is shared read-only by the parallel phase, so build it up front, but only if some
+    // turret lost its lock: when every turret keeps its target there is nothing to rescan.
+    // The range test compares squared distances, exactly and without a square root, like the grid query.
+    auto needsTarget = [this](const Turret& turret) {
+        size_t locked = enemies.index.Find(turret.target);
+        return locked == SlotIndex::NONE || DistanceSqr(turret.position, enemies.Position(locked)) >= turret.range * turret.range ||
+            !turret.sight.Visible(TileAt(enemies.Position(locked)));
+    };
+    if (std::any_of(turrets.begin(), turrets.end(), needsTarget))
+    {
+        enemyGrid.Begin(enemies.size());
+        for (size_t i = 0; i < enemies.size(); i++)
+            enemyGrid.Insert((int)i, enemies.Position(i));
+        enemyGrid.End();
+    }
+
+    // Each turret only touches its own state; bullet spawns go to the chunk's buffer.
+    size_t chunkCount = JobSystem::ChunkCount(turrets.size(), TURRET_GRAIN);
+    PrepareBuffers(spawnBuffers, chunkCount);
+    jobs->ParallelFor(turrets.size(), TURRET_GRAIN, [&](size_t chunk, size_t begin, size_t end) {
+        PROFILE_SCOPE("Targeting.Chunk");
+        for (size_t t = begin; t < end; t++)
+        {
+            Turret& turret = turrets[t];            // [HW3] For every turret in the vector spawned...
+            turret.currentCDT += dt;                // [HW3] Increase its current cool down float in real time.
+
+            size_t locked = enemies.index.Find(turret.target);
+            if (needsTarget(turret))
+            {
+                // Only visit the cells overlapping the turret's range and lock onto the visible enemy furthest
+                // along the path. Ties go to the higher dense index so the result doesn't depend on query order.
+                // Sight is tested on the leader first; only if it is hidden does a second scan test every
+                // candidate, so a turret with a clear view pays one bit test per scan.
+                auto furthest = [this, &turret](bool checkSight) {
+                    int target = -1;
+                    enemyGrid.Query(turret.position, turret.range, [this, &turret, &target, checkSight](int id, Vector2 position) {
+                        bool ahead = target < 0 || enemies.distance[id] > enemies.distance[target] ||
+                            (enemies.distance[id] == enemies.distance[target] && id > target);
+                        if (ahead && (!checkSight || turret.sight.Visible(TileAt(position))))
+                            target = id;
+                    });
+                    return target;
+                };
+                int target = furthest(false);
+                if (target >= 0 && !turret.sight.Visible(TileAt(enemies.Position(target))))
+                    target = furthest(true);
+                turret.target = target >= 0 ? enemies.index.HandleAt(target) : Handle{};
+                locked = target >= 0 ? (size_t)target : SlotIndex::NONE;
+            }
+
+            if (locked != SlotIndex::NONE && turret.currentCDT >= turret.rateOfFire)   // [HW3] If target enemies exist AND turret cool down passes the rate of fire.
+            {
+                turret.currentCDT = 0.0f;                                           // [HW3] Reset turret cool down.
+                Bullet bullet;                                                      // [HW3] Creates bullet from bullet struct. (Moved this chunk from existing code)
+                bullet.position = turret.position;                                  // [HW3] Bullet position starts on the active turret position.
+                bullet.direction = Normalize(enemies.Position(locked) - bullet.position);   // [HW3] Aims bullet at target using the target direction and distance.
+                spawnBuffers[chunk].push_back(bullet);
+            }
+        }
+    });
+
+    // Merge in chunk order: the same bullet order a serial loop over turrets would produce.
+    for (size_t chunk = 0; chunk < chunkCount; chunk++)
+    {
+        for (const Bullet& bullet : spawnBuffers[chunk])
+            bullets.Insert(bullet);                                             // [HW3] Place new bullet on the end of bullets vector.
+    }
+}
+
+void Simulation::MoveBullets(float dt)
+{
+    PROFILE_SCOPE("BulletMovement");
+    // Each chunk moves a disjoint slice of the columns, so there is nothing to merge.
+    float step = config.bulletSpeed * dt;
+    jobs->ParallelFor(bullets.size(), BULLET_GRAIN, [&](size_t, size_t begin, size_t end) {
+        PROFILE_SCOPE("BulletMovement.Chunk");
+        MoveKernel(bullets.x.data() + begin, bullets.y.data() + begin, bullets.dirX.data() + begin,
+            bullets.dirY.data() + begin, step, end - begin);
+        AddKernel(bullets.time.data() + begin, dt, end - begin);
+    });
+}
+
+void Simulation::CollideBullets()
+{
+    PROFILE_SCOPE("Collision");
+    // Broadphase: bring the proxies up to date with this tick's spawns and positions.
+    broadphase.Grow(BULLET_LAYER, (int)bullets.size());
+    broadphase.Grow(ENEMY_LAYER, (int)enemies.size());
+    broadphase.Update([this](int layer, int index, float& minX, float& maxX, float& minY, float& maxY) {
+        Vector2 position = layer == BULLET_LAYER ? bullets.Position(index) : enemies.Position(index);
+        float radius = layer == BULLET_LAYER ? config.bulletRadius : config.enemyRadius;
+        minX = position.x - radius;
+        maxX = position.x + radius;
+        minY = position.y - radius;
+        maxY = position.y + radius;
+    });
+    broadphase.FindPairs(pairs);
+
+    // Narrowphase: the circle tests are independent, so run them in parallel and collect the
+    // overlapping pair indices per chunk.
+    size_t chunkCount = JobSystem::ChunkCount(pairs.size(), PAIR_GRAIN);
+    PrepareBuffers(hitBuffers, chunkCount);
+    jobs->ParallelFor(pairs.size(), PAIR_GRAIN, [&](size_t chunk, size_t begin, size_t end) {
+        PROFILE_SCOPE("Collision.Chunk");
+        for (size_t p = begin; p < end; p++)
+        {
+            const BroadphasePair& pair = pairs[p];
+            if (CirclesOverlap(enemies.Position(pair.b), config.enemyRadius, bullets.Position(pair.a), config.bulletRadius))
+                hitBuffers[chunk].push_back((uint32_t)p);
+        }
+    });
+
+    // Resolve hits serially in pair order (bullet then enemy, the order the old nested loop used).
+    // Kills are only flagged here; RemoveDead compacts the arrays once at the end of the tick.
+    for (size_t chunk = 0; chunk < chunkCount; chunk++)
+    {
+        for (uint32_t p : hitBuffers[chunk])
+        {
+            const BroadphasePair& pair = pairs[p];
+            if (!bullets.enabled[pair.a] || enemies.health[pair.b] <= 0)   // Bullet already spent, or enemy already killed this tick.
+                continue;
+
+            // The old loop re-tested the same enemy without advancing until its health ran out,
+            // so a hit has always been a kill; keep that rule explicitly.
+            enemies.health[pair.b] = 0;
+            bullets.enabled[pair.a] = false;
+        }
+    }
+}
+
+void Simulation::RemoveDead()
+{
+    PROFILE_SCOPE("Removal");
+    // Swap-remove from the back so the value moved into each hole has already been checked,
+    // recording where every survivor moved so the broadphase can follow.
+    auto compact = [this](auto& items, int layer, auto isDead) {
+        remap.resize(items.size());
+        origin.resize(items.size());
+        for (size_t i = 0; i < items.size(); i++)
+            remap[i] = origin[i] = (int)i;
+
+        for (size_t i = items.size(); i-- > 0;)
+        {
+            if (!isDead(i))
+                continue;
+            size_t last = items.size() - 1;
+            remap[origin[i]] = -1;
+            if (i != last)
+            {
+                origin[i] = origin[last];
+                remap[origin[i]] = (int)i;
+            }
+            items.RemoveAt(i);
+        }
+        broadphase.Remap(layer, remap);
+    };
+
+    compact(enemies, ENEMY_LAYER, [this](size_t i) {
+        return enemies.health[i] <= 0;
+    });
+    compact(bullets, BULLET_LAYER, [this](size_t i) {
+        return !bullets.enabled[i] || bullets.time[i] >= config.bulletTime;
+    });
+}
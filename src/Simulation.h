@@ -0,0 +1,137 @@
+#pragma once
+#include "Grid.h"
+#include "ChunkedTileMap.h"
+#include "Path.h"
+#include "Pathfinder.h"
+#include "FlowField.h"
+#include "Connectivity.h"
+#include "SpatialHash.h"
+#include "Broadphase.h"
+#include "Entities.h"
+#include "JobSystem.h"
+
+#include <memory>
+#include <vector>
+
+// Fixed update rate used by both the windowed loop and the headless driver.
+const float FIXED_DT = 1.0f / 60.0f;
+
+struct SimulationConfig
+{
+    // -- ENEMY VARIABLES ------------
+    float enemySpeed = 250.0f;
+    float enemyRadius = 20.0f;
+    float spawnStall = 1.0f;    // Time between enemy spawns.
+    int enemyTotal = 10;        // Enemy count limit to enemy spawning.
+    bool flowFieldSteering = false;     // Steer by the goal flow field instead of following the baked path.
+
+    // -- BULLET VARIABLES ------------
+    float bulletTime = 1.0f;
+    float bulletSpeed = 500.0f;
+    float bulletRadius = 15.0f;
+
+    // -- TARGETING VARIABLES ------------
+    float targetingCellSize = 125.0f;   // Spatial hash cell size, half the default turret range.
+
+    // -- THREADING VARIABLES ------------
+    unsigned threadCount = 1;   // Threads for the turret, bullet and collision phases. 0 = every hardware thread.
+};
+
+// Update phases in the order Step runs them, for per-phase timing.
+enum SimulationPhase
+{
+    PHASE_SPAWNING,
+    PHASE_PATH_FOLLOWING,
+    PHASE_TARGETING,
+    PHASE_BULLET_MOVEMENT,
+    PHASE_COLLISION,
+    PHASE_REMOVAL,
+    PHASE_COUNT
+};
+
+const char* PhaseName(SimulationPhase phase);
+
+// Owns the whole game state and advances it by a fixed step.
+// Makes no raylib calls so it can run without a window or GL context.
+class Simulation
+{
+public:
+    Simulation(TileView tiles, Cell spawn, Cell goal, SimulationConfig config = {});
+
+    void Step(float dt);
+
+    // Changes one tile at runtime, adding or removing its turret, and repairs the enemy route.
+    // Edits that would leave no route from spawn to goal are refused and return false.
+    // Path-following enemies keep their distance along the path, so ones past a detour jump onto
+    // the new route; flow-field enemies just follow the rebuilt field from where they stand.
+    // Placing or clearing rock rebuilds the sight masks of the turrets whose range reaches the tile.
+    bool SetTile(Cell cell, TileType type);
+
+    // True if building on the cell would cut spawn off from goal. O(1), cheap enough for every hover.
+    bool WouldBlockRoute(Cell cell) const { return IsWalkable(tiles.Get(cell)) && connectivity.WouldDisconnect(cell); }
+
+    // Direct entity placement for scenarios and benchmarks; normal play spawns through Step.
+    Handle SpawnEnemy(float distance);
+    void AddTurret(Vector2 position);
+    Handle SpawnBullet(const Bullet& bullet);
+
+    int Tile(int row, int col) const { return tiles.Get(row, col); }
+    const ChunkedTileMap& Tiles() const { return tiles; }
+    const std::vector<Cell>& Route() const { return route; }
+    const std::vector<Cell>& Waypoints() const { return waypoints; }
+    const Path& EnemyPath() const { return path; }
+    const FlowField& Flow() const { return flow; }       // Empty unless config.flowFieldSteering.
+    const EnemyStore& Enemies() const { return enemies; }
+    const std::vector<Turret>& Turrets() const { return turrets; }
+    const BulletStore& Bullets() const { return bullets; }
+    const SimulationConfig& Config() const { return config; }
+
+    int EnemiesSpawned() const { return enemySpawned; }
+    long long TickCount() const { return tickCount; }
+
+    // Time spent in each phase since construction or the last ResetPhaseTimes, in nanoseconds.
+    double PhaseNanoseconds(SimulationPhase phase) const;
+    void ResetPhaseTimes();
+
+    // Bytes currently reserved by entity storage and per-tick scratch buffers.
+    size_t MemoryBytes() const;
+
+private:
+    void SpawnEnemies(float dt);
+    void MoveEnemies(float dt);
+    void SteerEnemies(float dt);
+    void UpdateTurrets(float dt);
+    void MoveBullets(float dt);
+    void CollideBullets();
+    void RemoveDead();
+    void RebuildPath();
+    void BuildSight(Turret& turret);
+
+    ChunkedTileMap tiles;           // Chunk versions tell render and other caches what changed.
+    SimulationConfig config;
+
+    DStarLite planner;              // Keeps its search between tile edits so replanning stays local.
+    Connectivity connectivity;      // Which road cells the route can't do without.
+    std::vector<Cell> route;        // Every cell from spawn to goal.
+    std::vector<Cell> waypoints;    // Turning points of route.
+    Path path;                      // Segment table baked from waypoints.
+    FlowField flow;                 // Every walkable cell's next step to the goal; built only for flowFieldSteering.
+    BulletStore bullets;
+    EnemyStore enemies;             // [HW3] Creates vector to hold number of enemies.
+    std::vector<Turret> turrets;    // [HW3] Creates vector to hold number of turrets.
+    SpatialHash enemyGrid;          // Enemies re-binned each tick for turret target acquisition.
+    SweepAndPrune broadphase;       // Bullet-vs-enemy candidate pairs, sorted order kept between ticks.
+    std::vector<BroadphasePair> pairs;
+    std::vector<int> remap;
+    std::vector<int> origin;
+
+    // Phases write into one buffer per chunk and merge in chunk order, so results are identical for any thread count.
+    std::unique_ptr<JobSystem> jobs;
+    std::vector<std::vector<Bullet>> spawnBuffers;
+    std::vector<std::vector<uint32_t>> hitBuffers;
+
+    float enemyCDT = 0.0f;      // [HW3]    Enemy spawn cooldown timer.
+    int enemySpawned = 0;       // [HW3]    Current count of enemies spawned.
+    long long tickCount = 0;
+    uint64_t phaseTicks[PHASE_COUNT]{};     // ProfilerNow ticks, always on (a few timestamps per tick).
+};
@@ -0,0 +1,118 @@
+#pragma once
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Stable reference to an object in SlotIndex-backed storage. Stays valid until the object it names
+// is removed; after that SlotIndex::Find returns NONE instead of a stale index, even if the slot is reused.
+struct Handle
+{
+    uint32_t index = UINT32_MAX;
+    uint32_t generation = 0;
+
+    bool operator==(const Handle& other) const { return index == other.index && generation == other.generation; }
+    bool operator!=(const Handle& other) const { return !(*this == other); }
+};
+
+// Handle bookkeeping for dense storage that lives elsewhere (a std::vector, or several
+// structure-of-arrays columns). The owner appends on Insert and mirrors every RemoveAt
+// by moving its last element into the removed position.
+class SlotIndex
+{
+public:
+    static const size_t NONE = SIZE_MAX;
+
+    // The new object's dense index is the size before the call.
+    Handle Insert();
+    void RemoveAt(size_t denseIndex);
+
+    // Dense index of a live handle, or NONE if it is stale.
+    size_t Find(Handle handle) const;
+    Handle HandleAt(size_t denseIndex) const;
+
+    size_t Size() const { return denseToSlot.size(); }
+    size_t MemoryBytes() const { return denseToSlot.capacity() * sizeof(uint32_t) + slots.capacity() * sizeof(Slot); }
+    void Reserve(size_t count);
+
+private:
+    static const uint32_t FREE_END = UINT32_MAX;
+
+    struct Slot
+    {
+        uint32_t dense;         // Position in the dense storage while alive, next free slot while free.
+        uint32_t generation;    // Bumped on every removal so old handles stop matching.
+        bool alive;
+    };
+
+    std::vector<uint32_t> denseToSlot;
+    std::vector<Slot> slots;
+    uint32_t freeHead = FREE_END;
+};
+
+inline Handle SlotIndex::Insert()
+{
+    uint32_t slotIndex;
+    if (freeHead != FREE_END)
+    {
+        slotIndex = freeHead;
+        freeHead = slots[slotIndex].dense;
+    }
+    else
+    {
+        slotIndex = (uint32_t)slots.size();
+        slots.push_back({ FREE_END, 0, false });
+    }
+
+    Slot& slot = slots[slotIndex];
+    slot.dense = (uint32_t)denseToSlot.size();
+    slot.alive = true;
+    denseToSlot.push_back(slotIndex);
+    return { slotIndex, slot.generation };
+}
+
+inline void SlotIndex::RemoveAt(size_t denseIndex)
+{
+    assert(denseIndex < denseToSlot.size());
+    uint32_t slotIndex = denseToSlot[denseIndex];
+
+    // The last object moves into the hole, so repoint its slot.
+    denseToSlot[denseIndex] = denseToSlot.back();
+    slots[denseToSlot[denseIndex]].dense = (uint32_t)denseIndex;
+    denseToSlot.pop_back();
+
+    Slot& slot = slots[slotIndex];
+    slot.alive = false;
+    slot.generation++;
+    slot.dense = freeHead;
+    freeHead = slotIndex;
+}
+
+inline size_t SlotIndex::Find(Handle handle) const
+{
+    if (handle.index >= slots.size())
+        return NONE;
+    const Slot& slot = slots[handle.index];
+    return slot.alive && slot.generation == handle.generation ? slot.dense : NONE;
+}
+
+inline Handle SlotIndex::HandleAt(size_t denseIndex) const
+{
+    uint32_t slotIndex = denseToSlot[denseIndex];
+    return { slotIndex, slots[slotIndex].generation };
+}
+
+inline void SlotIndex::Reserve(size_t count)
+{
+    denseToSlot.reserve(count);
+    slots.reserve(count);
+}
+
+// Removes element i from a dense column the same way SlotIndex::RemoveAt does.
+template<typename T>
+void SwapRemove(std::vector<T>& column, size_t i)
+{
+    column[i] = std::move(column.back());
+    column.pop_back();
+}
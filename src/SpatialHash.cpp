@@ -0,0 +1,38 @@
+#include "SpatialHash.h"
+
+SpatialHash::SpatialHash(float cellSize)
+    : cellSize(cellSize), inverseCellSize(1.0f / cellSize)
+{
+}
+
+void SpatialHash::Begin(size_t count)
+{
+    entries.clear();
+    entries.reserve(count);
+}
+
+void SpatialHash::Insert(int id, Vector2 position)
+{
+    entries.push_back({ position, id, CellCoord(position.x), CellCoord(position.y) });
+}
+
+void SpatialHash::End()
+{
+    // Keep roughly two buckets per entry so collisions between cells stay rare.
+    size_t bucketCount = 64;
+    while (bucketCount < entries.size() * 2)
+        bucketCount *= 2;
+    bucketMask = bucketCount - 1;
+
+    // Counting sort: count per bucket, prefix sum into start offsets, then scatter.
+    bucketStart.assign(bucketCount + 1, 0);
+    for (const Entry& entry : entries)
+        bucketStart[Bucket(entry.cellX, entry.cellY) + 1]++;
+    for (size_t i = 1; i <= bucketCount; i++)
+        bucketStart[i] += bucketStart[i - 1];
+
+    sorted.resize(entries.size());
+    cursor.assign(bucketStart.begin(), bucketStart.end() - 1);
+    for (const Entry& entry : entries)
+        sorted[cursor[Bucket(entry.cellX, entry.cellY)]++] = entry;
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include "Math.h"
+
+#include <cmath>
+#include <vector>
+
+// Uniform grid of square cells hashed into a fixed bucket table.
+// Entities are re-binned every tick with Begin/Insert/End (a counting sort, no per-cell allocations),
+// then Query visits only the cells overlapping a circle instead of every entity.
+class SpatialHash
+{
+public:
+    explicit SpatialHash(float cellSize);
+
+    // Starts a rebuild, discarding the previous contents.
+    void Begin(size_t count);
+    void Insert(int id, Vector2 position);
+    // Sorts the inserted entries into their buckets. Must be called before Query.
+    void End();
+
+    // Calls fn(id, position) for every entry strictly inside the circle.
+    template<typename Fn>
+    void Query(Vector2 center, float radius, Fn&& fn) const;
+
+    float CellSize() const { return cellSize; }
+    size_t Size() const { return entries.size(); }
+    size_t MemoryBytes() const
+    {
+        return (entries.capacity() + sorted.capacity()) * sizeof(Entry) + (bucketStart.capacity() + cursor.capacity()) * sizeof(int);
+    }
+
+private:
+    struct Entry
+    {
+        Vector2 position;
+        int id;
+        int cellX;
+        int cellY;
+    };
+
+    int CellCoord(float value) const { return (int)floorf(value * inverseCellSize); }
+    size_t Bucket(int cellX, int cellY) const
+    {
+        return (((unsigned)cellX * 73856093u) ^ ((unsigned)cellY * 19349663u)) & bucketMask;
+    }
+
+    float cellSize;
+    float inverseCellSize;
+    size_t bucketMask = 0;
+
+    std::vector<Entry> entries;         // Unsorted entries while inserting.
+    std::vector<Entry> sorted;          // Entries grouped by bucket after End().
+    std::vector<int> bucketStart;       // bucketStart[b]..bucketStart[b + 1] indexes into sorted.
+    std::vector<int> cursor;            // Scatter position per bucket, kept to avoid reallocating.
+};
+
+template<typename Fn>
+void SpatialHash::Query(Vector2 center, float radius, Fn&& fn) const
+{
+    if (sorted.empty())
+        return;
+
+    float radiusSqr = radius * radius;
+    int minX = CellCoord(center.x - radius);
+    int maxX = CellCoord(center.x + radius);
+    int minY = CellCoord(center.y - radius);
+    int maxY = CellCoord(center.y + radius);
+    for (int cellY = minY; cellY <= maxY; cellY++)
+    {
+        for (int cellX = minX; cellX <= maxX; cellX++)
+        {
+            size_t bucket = Bucket(cellX, cellY);
+            for (int i = bucketStart[bucket]; i < bucketStart[bucket + 1]; i++)
+            {
+                // Different cells can share a bucket, so skip entries that belong to another cell.
+                const Entry& entry = sorted[i];
+                if (entry.cellX != cellX || entry.cellY != cellY)
+                    continue;
+                if (DistanceSqr(center, entry.position) < radiusSqr)
+                    fn(entry.id, entry.position);
+            }
+        }
+    }
+}
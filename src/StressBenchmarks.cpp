@@ -0,0 +1,156 @@
+#include "Benchmarks.h"
+#include "Memory.h"
+#include "Simulation.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+
+struct StressScenario
+{
+    const char* name;
+    std::function<void(SimulationConfig&)> configure;
+    std::function<void(Simulation&)> populate;
+};
+
+static Vector2 RandomScreenPosition()
+{
+    return { Random(0.0f, SCREEN_SIZE), Random(0.0f, SCREEN_SIZE) };
+}
+
+// Spreads enemies evenly along the whole path so every segment and turret sees traffic.
+static void SpreadEnemies(Simulation& simulation, int count)
+{
+    float length = simulation.EnemyPath().Length();
+    for (int i = 0; i < count; i++)
+        simulation.SpawnEnemy(length * i / count);
+}
+
+static void AddRandomTurrets(Simulation& simulation, int count)
+{
+    for (int i = 0; i < count; i++)
+        simulation.AddTurret(RandomScreenPosition());
+}
+
+static void AddRandomBullets(Simulation& simulation, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        Bullet bullet;
+        bullet.position = RandomScreenPosition();
+        bullet.direction = Normalize(Vector2{ Random(-1.0f, 1.0f), Random(-1.0f, 1.0f) });
+        simulation.SpawnBullet(bullet);
+    }
+}
+
+// reportRss: the process ran this scenario alone, so its peak resident size is the scenario's.
+static void RunScenario(const StressScenario& scenario, long long ticks, unsigned threadCount, bool reportRss)
+{
+    const int warmupTicks = 10;
+
+    srand(1234);
+    SimulationConfig config;
+    config.enemyTotal = 0;
+    config.threadCount = threadCount;
+    scenario.configure(config);
+    Simulation simulation(LEVEL_TILES, LEVEL_SPAWN, LEVEL_GOAL, config);
+    scenario.populate(simulation);
+
+    for (int tick = 0; tick < warmupTicks; tick++)
+        simulation.Step(FIXED_DT);
+    simulation.ResetPhaseTimes();
+
+    double entityTicks = 0.0;
+    size_t peakSimBytes = simulation.MemoryBytes();
+    auto begin = std::chrono::steady_clock::now();
+    for (long long tick = 0; tick < ticks; tick++)
+    {
+        simulation.Step(FIXED_DT);
+        entityTicks += simulation.Enemies().size() + simulation.Bullets().size() + simulation.Turrets().size();
+        peakSimBytes = std::max(peakSimBytes, simulation.MemoryBytes());
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    printf("{\"scenario\":\"%s\",\"ticks\":%lld,\"threads\":%u,\"nsPerTick\":%.0f,\"phaseNsPerTick\":{",
+        scenario.name, ticks, threadCount, seconds * 1e9 / ticks);
+    for (int phase = 0; phase < PHASE_COUNT; phase++)
+    {
+        printf("%s\"%s\":%.0f", phase > 0 ? "," : "", PhaseName((SimulationPhase)phase),
+            simulation.PhaseNanoseconds((SimulationPhase)phase) / ticks);
+    }
+    printf("},\"entitiesPerSecond\":%.0f,\"enemies\":%zu,\"bullets\":%zu,\"turrets\":%zu,\"peakSimBytes\":%zu",
+        entityTicks / seconds, simulation.Enemies().size(), simulation.Bullets().size(), simulation.Turrets().size(),
+        peakSimBytes);
+    if (reportRss)
+        printf(",\"peakRssBytes\":%zu", PeakResidentBytes());
+    printf("}\n");
+    fflush(stdout);
+}
+
+int RunStressBenchmarks(long long ticks, unsigned threadCount, const char* only)
+{
+    if (ticks <= 0)
+        ticks = 1;
+
+    const StressScenario scenarios[] = {
+        // 10k enemies walking the level past its three turrets.
+        { "enemies_10k",
+            [](SimulationConfig&) {},
+            [](Simulation& simulation) { SpreadEnemies(simulation, 10000); } },
+
+        // The same crowd steering by the goal flow field instead of the baked path.
+        { "enemies_10k_flow",
+            [](SimulationConfig& config) { config.flowFieldSteering = true; },
+            [](Simulation& simulation) { SpreadEnemies(simulation, 10000); } },
+
+        // 1k turrets scattered over the map, firing into a steady crowd.
+        { "turrets_1k",
+            [](SimulationConfig&) {},
+            [](Simulation& simulation) {
+                AddRandomTurrets(simulation, 1000);
+                SpreadEnemies(simulation, 2000);
+            } },
+
+        // 100k long-lived bullets crossing a thin line of enemies.
+        { "bullets_100k",
+            [](SimulationConfig& config) { config.bulletTime = 1e9f; },
+            [](Simulation& simulation) {
+                AddRandomBullets(simulation, 100000);
+                SpreadEnemies(simulation, 1000);
+            } },
+
+        // A wave spawning one enemy per tick into 200 extra turrets, plus bullets already in flight.
+        { "mixed_wave",
+            [](SimulationConfig& config) {
+                config.enemyTotal = 5000;
+                config.spawnStall = 0.0f;
+            },
+            [](Simulation& simulation) {
+                AddRandomTurrets(simulation, 200);
+                SpreadEnemies(simulation, 2000);
+                AddRandomBullets(simulation, 20000);
+            } },
+    };
+
+    // The peak resident size covers the whole process, so it is only reported for a lone scenario.
+    bool found = false;
+    for (const StressScenario& scenario : scenarios)
+    {
+        if (only && strcmp(only, scenario.name) != 0)
+            continue;
+        RunScenario(scenario, ticks, threadCount, only != nullptr);
+        found = true;
+    }
+    if (!found)
+    {
+        printf("unknown stress scenario '%s'; scenarios:", only);
+        for (const StressScenario& scenario : scenarios)
+            printf(" %s", scenario.name);
+        printf("\n");
+        return 1;
+    }
+    return 0;
+}